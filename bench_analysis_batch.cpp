@@ -0,0 +1,134 @@
+// RiskEngine over a block-sized burst: analyze_transaction once per tx
+// against one analyze_batch call over the same transactions.
+//
+//   g++ -std=c++17 -O2 -Isrc bench_analysis_batch.cpp -lspdlog -lfmt -pthread -o bench_analysis_batch
+//   ./bench_analysis_batch
+//
+// Half of the burst are swapExactETHForTokens calls into the Uniswap V2
+// router (WETH -> USDC against a cached pair, random size and slippage
+// tolerance), the rest plain transfers. Every batch row is first checked
+// against the single-transaction result.
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "analytics/risk_engine.hpp"
+
+namespace {
+
+using namespace mev_shield;
+
+const Address kWeth = Address::from_hex(std::string("0xC02aaA39b223FE8D0A0e5C4F27eAD9083C756Cc2"));
+const Address kUsdc = Address::from_hex(std::string("0xA0b86991c6218b36c1d19D4a2e9Eb0cE3606eB48"));
+const Address kRouter = Address::from_hex(std::string("0x7a250d5630B4cF539739dF2C5dAcb4c659F2488D"));
+
+void put_word(std::vector<uint8_t>& out, uint64_t value) {
+    out.insert(out.end(), 24, 0);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void put_address(std::vector<uint8_t>& out, const Address& address) {
+    out.insert(out.end(), 12, 0);
+    out.insert(out.end(), address.bytes, address.bytes + Address::kSize);
+}
+
+// swapExactETHForTokens(amountOutMin, [WETH, USDC], to, deadline)
+void make_swap(PendingTransaction& pending, const Uint256& amount_in, uint64_t min_out) {
+    std::vector<uint8_t>& data = pending.calldata_buffer;
+    data = {0x7f, 0xf3, 0x6a, 0xb5};
+    put_word(data, min_out);
+    put_word(data, 0x80);
+    put_address(data, kRouter);
+    put_word(data, 2000000000);
+    put_word(data, 2);
+    put_address(data, kWeth);
+    put_address(data, kUsdc);
+    pending.tx.to = kRouter;
+    pending.tx.has_to = true;
+    pending.tx.value = amount_in;
+    pending.tx.eth_value = wei_to_ether(amount_in);
+    pending.tx.calldata = ByteSpan{data.data(), data.size()};
+}
+
+template <typename Fn>
+double time_ns(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+} // namespace
+
+int main() {
+    Logger::get_instance().initialize("bench_analysis_batch");
+    auto cache = std::make_shared<PoolCache>();
+    Address pair;
+    cache->resolver().resolve(PoolVenue::UniswapV2, kWeth, kUsdc, 3000, pair);
+    cache->request_pair(PoolVenue::UniswapV2, kWeth, kUsdc, 3000);
+    Uint256 reserve_usdc = Uint256::from_u64(50000000ULL * 1000000ULL);
+    Uint256 reserve_weth = ether_to_wei(20000);
+    cache->apply_sync(pair, 1, 0, reserve_usdc, reserve_weth);
+    RiskEngine engine(0.01, 3.0, DEXRouters{}, cache);
+
+    const size_t burst = 2048;
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<PendingTransaction> txs(burst);
+    for (size_t i = 0; i < burst; ++i) {
+        if (i % 2 == 0) {
+            double eth = std::pow(10.0, -1.0 + 3.0 * unit(rng));
+            double expected = eth * 2500.0 * 1e6 * 0.997 / (1.0 + eth / 20000.0);
+            make_swap(txs[i], Uint256::from_u64(static_cast<uint64_t>(eth * 1e9)) * Uint256::from_u64(1000000000ULL),
+                      static_cast<uint64_t>(expected * (1.0 - 0.03 * unit(rng))));
+        } else {
+            txs[i].tx.to = kWeth;
+            txs[i].tx.has_to = true;
+            txs[i].tx.value = ether_to_wei(1);
+        }
+    }
+
+    TransactionBatch batch(burst);
+    AnalysisBatch results(burst);
+    for (const auto& pending : txs) {
+        batch.push(pending.tx, engine.routers());
+    }
+    engine.analyze_batch(batch, results);
+
+    size_t high = 0;
+    for (size_t i = 0; i < burst; ++i) {
+        TransactionAnalysis single = engine.analyze_transaction(txs[i].tx);
+        TransactionAnalysis row = engine.describe(results, i);
+        if (single.risk_level != row.risk_level || single.risk_factors != row.risk_factors || single.risk_reason != row.risk_reason ||
+            single.estimated_mev_profit_eth != row.estimated_mev_profit_eth) {
+            std::cerr << "row " << i << " differs from the single-transaction result" << std::endl;
+            return 1;
+        }
+        high += results.risk_level[i] == TransactionAnalysis::HIGH ? 1 : 0;
+    }
+    std::cout << high << "/" << burst << " transactions HIGH risk\n";
+
+    volatile size_t sink = 0;
+    double single_ns = time_ns(20, [&]() {
+        for (const auto& pending : txs) {
+            sink = sink + engine.analyze_transaction(pending.tx).risk_factors;
+        }
+    }) / burst;
+    double batch_ns = time_ns(20, [&]() {
+        batch.clear();
+        for (const auto& pending : txs) {
+            batch.push(pending.tx, engine.routers());
+        }
+        engine.analyze_batch(batch, results);
+        sink = sink + results.risk_level[0];
+    }) / burst;
+
+    std::cout << "analyze_transaction: " << single_ns << " ns/tx\n";
+    std::cout << "analyze_batch:       " << batch_ns << " ns/tx\n";
+    return 0;
+}
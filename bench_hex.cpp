@@ -0,0 +1,123 @@
+// Hex codec throughput for each kernel the CPU supports.
+//
+//   g++ -std=c++17 -O2 -Isrc bench_hex.cpp -o bench_hex
+//   ./bench_hex
+//
+// Sizes cover an address (20 bytes), a hash (32 bytes), a typical V2 swap
+// (~260 bytes of calldata) and a Universal Router batch (~4 KB). Every
+// kernel is first checked against the scalar reference.
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/hex.hpp"
+
+namespace {
+
+using DecodeFn = bool (*)(const char*, size_t, uint8_t*);
+using EncodeFn = void (*)(const uint8_t*, size_t, char*);
+
+struct Kernel {
+    const char* name;
+    DecodeFn decode;
+    EncodeFn encode;
+};
+
+std::vector<Kernel> available_kernels() {
+    std::vector<Kernel> kernels = {{"scalar", &mev_shield::hex::decode_scalar, &mev_shield::hex::encode_scalar}};
+#ifdef MEV_SHIELD_HEX_SIMD
+    if (__builtin_cpu_supports("sse4.1")) {
+        kernels.push_back({"sse4.1", &mev_shield::hex::decode_sse41, &mev_shield::hex::encode_sse41});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({"avx2", &mev_shield::hex::decode_avx2, &mev_shield::hex::encode_avx2});
+    }
+#endif
+    return kernels;
+}
+
+bool verify(const Kernel& kernel, std::mt19937& rng) {
+    for (size_t size = 0; size < 300; ++size) {
+        std::vector<uint8_t> bytes(size);
+        for (auto& b : bytes) {
+            b = static_cast<uint8_t>(rng());
+        }
+        std::string expected(2 * size, '\0');
+        mev_shield::hex::encode_scalar(bytes.data(), size, &expected[0]);
+        std::string text(2 * size, '\0');
+        kernel.encode(bytes.data(), size, &text[0]);
+        if (text != expected) {
+            return false;
+        }
+        // Mixed case must decode; any stray character must be rejected
+        for (auto& c : text) {
+            if (rng() % 2) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        std::vector<uint8_t> decoded(size);
+        if (!kernel.decode(text.data(), size, decoded.data()) || decoded != bytes) {
+            return false;
+        }
+        if (size > 0) {
+            const char bad[] = {'g', 'G', ':', '/', '@', '`', ' ', '\x80', '\xff'};
+            text[rng() % text.size()] = bad[rng() % sizeof(bad)];
+            if (kernel.decode(text.data(), size, decoded.data())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    std::vector<Kernel> kernels = available_kernels();
+    std::cout << "Dispatch selects: " << mev_shield::hex::kernels().name << std::endl;
+    for (const auto& kernel : kernels) {
+        if (!verify(kernel, rng)) {
+            std::cout << "❌ " << kernel.name << " disagrees with the scalar kernel" << std::endl;
+            return 1;
+        }
+    }
+
+    const size_t sizes[] = {20, 32, 260, 4096};
+    const size_t kBytesPerRun = 64 << 20;
+    for (size_t size : sizes) {
+        std::vector<uint8_t> bytes(size);
+        for (auto& b : bytes) {
+            b = static_cast<uint8_t>(rng());
+        }
+        std::string text(2 * size, '\0');
+        mev_shield::hex::encode_scalar(bytes.data(), size, &text[0]);
+        size_t iterations = kBytesPerRun / size;
+
+        std::cout << "\n" << size << " bytes:" << std::endl;
+        for (const auto& kernel : kernels) {
+            size_t ok = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                ok += kernel.decode(text.data(), size, bytes.data());
+            }
+            double decode_ns = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                kernel.encode(bytes.data(), size, &text[0]);
+            }
+            double encode_ns = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count();
+
+            // Throughput counted in hex characters consumed / produced
+            double chars = 2.0 * size * iterations;
+            std::cout << "  " << kernel.name << ":\tdecode " << chars / decode_ns << " GB/s\tencode "
+                      << chars / encode_ns << " GB/s" << (ok == iterations ? "" : "  (decode failed!)")
+                      << std::endl;
+        }
+    }
+    return 0;
+}
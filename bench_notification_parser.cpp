@@ -0,0 +1,135 @@
+// Compares the SAX notification fast path against the in-situ DOM path.
+//
+//   g++ -std=c++17 -O2 -Isrc bench_notification_parser.cpp -o bench_notification_parser -lspdlog -lfmt
+//   ./bench_notification_parser [frames.jsonl]
+//
+// frames.jsonl holds recorded websocket frames, one per line (e.g. captured
+// with `websocat ... | tee frames.jsonl`). Without it a built-in sample of a
+// hash notification and a full transaction notification is used.
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "common/parse_arena.hpp"
+#include "network/notification_parser.hpp"
+
+namespace {
+
+const char* kHashFrame =
+    R"({"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x9ce59a13059e417087c02d3236a0b1cc",)"
+    R"("result":"0x5a3c8d9e4b1f2a7c6e0d3b8f9a1c4e7d2b5f8a0c3e6d9b2f5a8c1e4d7b0a3f6c"}})";
+
+const char* kTransactionFrame =
+    R"({"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x9ce59a13059e417087c02d3236a0b1cc",)"
+    R"("result":{"blockHash":null,"blockNumber":null,"from":"0x8ba1f109551bd432803012645ac136ddd64dba72",)"
+    R"("gas":"0x3d090","gasPrice":"0x4a817c800","maxFeePerGas":"0x6fc23ac00","maxPriorityFeePerGas":"0x3b9aca00",)"
+    R"("hash":"0x5a3c8d9e4b1f2a7c6e0d3b8f9a1c4e7d2b5f8a0c3e6d9b2f5a8c1e4d7b0a3f6c",)"
+    R"("input":"0x7ff36ab50000000000000000000000000000000000000000000000000de0b6b3a7640000)"
+    R"(00000000000000000000000000000000000000000000000000000000000000800000000000000000)"
+    R"(0000000008ba1f109551bd432803012645ac136ddd64dba7200000000000000000000000000000000)"
+    R"(00000000000000000000000000000000659f0c4000000000000000000000000000000000000000000)"
+    R"(000000000000000000000002000000000000000000000000c02aaa39b223fe8d0a0e5c4f27ead9083c)"
+    R"(756cc20000000000000000000000006b175474e89094c44da98b954eedeac495271d0f",)"
+    R"("nonce":"0x1a","to":"0x7a250d5630b4cf539739df2c5dacb4c659f2488d","transactionIndex":null,)"
+    R"("value":"0x1bc16d674ec80000","type":"0x2","accessList":[{"address":"0xc02aaa39b223fe8d0a0e5c4f27ead9083c756cc2",)"
+    R"("storageKeys":["0x0000000000000000000000000000000000000000000000000000000000000003"]}],)"
+    R"("chainId":"0x1","v":"0x1","r":"0x1b5e176d927f8e9ab405058b2d2457392da3e20f328b16ddabcebc33eaac5fea",)"
+    R"("s":"0x4ba69724e8f69de52f0125ad8b3c5c2cef33019bac3249e2c0a2192766d1721c"}}})";
+
+// Mirrors the DOM branch of MempoolMonitor::process_websocket_message
+bool parse_dom(mev_shield::ParseArena& arena, std::string& frame, mev_shield::PendingTransaction& tx) {
+    arena.reset();
+    mev_shield::ParseArena::Document doc = arena.make_document();
+    doc.ParseInsitu(&frame[0]);
+    if (doc.HasParseError() || !doc.IsObject() ||
+        !doc.HasMember("params") || !doc["params"].IsObject()) {
+        return false;
+    }
+    const auto& params = doc["params"];
+    if (!params.HasMember("subscription") || !params.HasMember("result")) {
+        return false;
+    }
+    if (params["result"].IsObject()) {
+        mev_shield::decode_transaction(params["result"], tx);
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> frames;
+    if (argc > 1) {
+        std::ifstream file(argv[1]);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                frames.push_back(line);
+            }
+        }
+        std::cout << "📼 Loaded " << frames.size() << " recorded frames from " << argv[1] << std::endl;
+    } else {
+        frames = {kHashFrame, kTransactionFrame};
+        std::cout << "📼 Using built-in sample frames" << std::endl;
+    }
+    if (frames.empty()) {
+        std::cout << "❌ No frames to benchmark" << std::endl;
+        return 1;
+    }
+
+    size_t total_bytes = 0;
+    for (const auto& frame : frames) {
+        total_bytes += frame.size();
+    }
+    const size_t iterations = std::max<size_t>(1, 2000000 / frames.size());
+
+    // In-situ DOM parse needs a fresh copy of each frame every time; the copy
+    // is timed separately so it can be subtracted
+    std::vector<std::string> scratch(frames);
+    auto copy_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (size_t f = 0; f < frames.size(); ++f) {
+            scratch[f].assign(frames[f]);
+        }
+    }
+    double copy_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - copy_start).count();
+
+    mev_shield::ParseArena arena;
+    mev_shield::PendingTransaction tx;
+    size_t dom_ok = 0;
+    auto dom_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (size_t f = 0; f < frames.size(); ++f) {
+            scratch[f].assign(frames[f]);
+            dom_ok += parse_dom(arena, scratch[f], tx);
+        }
+    }
+    double dom_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - dom_start).count() - copy_ns;
+
+    mev_shield::NotificationParser parser;
+    mev_shield::NotificationParser::Notification notification;
+    size_t sax_ok = 0;
+    auto sax_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (const auto& frame : frames) {
+            sax_ok += parser.parse(frame.c_str(), notification, tx);
+        }
+    }
+    double sax_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - sax_start).count();
+
+    double count = static_cast<double>(iterations * frames.size());
+    double bytes = static_cast<double>(iterations * total_bytes);
+    std::cout << "Frames parsed: " << static_cast<size_t>(count)
+              << " (" << total_bytes / frames.size() << " bytes avg)" << std::endl;
+    std::cout << "DOM (in situ): " << dom_ns / count << " ns/frame, "
+              << bytes / dom_ns << " GB/s, accepted " << dom_ok << std::endl;
+    std::cout << "SAX:           " << sax_ns / count << " ns/frame, "
+              << bytes / sax_ns << " GB/s, accepted " << sax_ok << std::endl;
+    std::cout << "Speedup:       " << dom_ns / sax_ns << "x" << std::endl;
+    return 0;
+}
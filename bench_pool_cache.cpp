@@ -0,0 +1,120 @@
+// Pool cache read path: seqlock snapshots with a writer applying Sync logs
+// in the background, and the price impact of a decoded swap.
+//
+//   g++ -std=c++17 -O2 -Isrc bench_pool_cache.cpp -lspdlog -lfmt -pthread -o bench_pool_cache
+//   ./bench_pool_cache
+//
+// The impact estimate is first checked against the exact V2 getAmountOut
+// formula in Uint256 arithmetic, and the CREATE2 resolver against the
+// mainnet WETH/USDC pair and 0.05% pool.
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include "analytics/price_impact.hpp"
+
+namespace {
+
+using namespace mev_shield;
+
+const Address kWeth = Address::from_hex(std::string("0xC02aaA39b223FE8D0A0e5C4F27eAD9083C756Cc2"));
+const Address kUsdc = Address::from_hex(std::string("0xA0b86991c6218b36c1d19D4a2e9Eb0cE3606eB48"));
+
+template <typename Fn>
+double time_ns(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+bool check_resolver(const PoolResolver& resolver) {
+    Address pool;
+    bool ok = resolver.resolve(PoolVenue::UniswapV2, kWeth, kUsdc, 3000, pool) &&
+              pool.to_hex() == "0xb4e16d0168e52d35cacd2c6185b44281ec28c9dc";
+    ok = ok && resolver.resolve(PoolVenue::UniswapV3, kUsdc, kWeth, 500, pool) &&
+         pool.to_hex() == "0x88e6a0c2ddd26feeb64f039a2c41296fcb3f5640";
+    return ok;
+}
+
+SwapLegs weth_to_usdc(SwapProtocol protocol, uint32_t fee, const Uint256& amount_in) {
+    SwapLegs legs;
+    SwapLeg* leg = legs.push();
+    leg->protocol = protocol;
+    leg->fee = fee;
+    leg->token_in = kWeth;
+    leg->token_out = kUsdc;
+    leg->amount_in = amount_in;
+    return legs;
+}
+
+} // namespace
+
+int main() {
+    Logger::get_instance().initialize("bench_pool_cache");
+    auto cache = std::make_shared<PoolCache>();
+    if (!check_resolver(cache->resolver())) {
+        std::cerr << "CREATE2 resolver mismatch" << std::endl;
+        return 1;
+    }
+
+    // USDC is token0 of the WETH/USDC pair: ~50M USDC against ~20k WETH
+    Address v2_pair;
+    Address v3_pool;
+    cache->resolver().resolve(PoolVenue::UniswapV2, kWeth, kUsdc, 3000, v2_pair);
+    cache->resolver().resolve(PoolVenue::UniswapV3, kWeth, kUsdc, 500, v3_pool);
+    cache->request_pair(PoolVenue::UniswapV2, kWeth, kUsdc, 3000);
+    cache->request_pair(PoolVenue::UniswapV3, kWeth, kUsdc, 500);
+    Uint256 reserve_usdc = Uint256::from_u64(50000000ULL * 1000000ULL);
+    Uint256 reserve_weth = ether_to_wei(20000);
+    cache->apply_sync(v2_pair, 1, 0, reserve_usdc, reserve_weth);
+    // Same depth in V3 terms: raw price 4e8 wei per USDC unit, so
+    // sqrt(P) = 2e4 and L = sqrt(5e13 * 2e22) = 1e18
+    Uint256 sqrt_price = Uint256::from_u64(20000) << 96;
+    cache->apply_swap(v3_pool, 1, 1, sqrt_price, ether_to_wei(1), 0);
+
+    // Exact check: 100 WETH into the V2 pair
+    Uint256 amount_in = ether_to_wei(100);
+    Uint256 in_with_fee = amount_in * Uint256::from_u64(997);
+    Uint256 exact_out = in_with_fee * reserve_usdc /
+                        (reserve_weth * Uint256::from_u64(1000) + in_with_fee);
+    double mid_out = amount_in.to_double() * reserve_usdc.to_double() / reserve_weth.to_double();
+    double exact_impact = (1.0 - exact_out.to_double() / (mid_out * 0.997)) * 100.0;
+
+    PriceImpactEstimator estimator(cache);
+    SwapLegs v2_legs = weth_to_usdc(SwapProtocol::UniswapV2, 3000, amount_in);
+    SwapLegs v3_legs = weth_to_usdc(SwapProtocol::UniswapV3, 500, amount_in);
+    PriceImpact v2_impact = estimator.estimate(v2_legs, PoolVenue::UniswapV2);
+    PriceImpact v3_impact = estimator.estimate(v3_legs, PoolVenue::UniswapV2);
+    std::cout << "V2 100 WETH impact: " << v2_impact.percent << "% (exact " << exact_impact << "%)\n";
+    std::cout << "V3 100 WETH impact: " << v3_impact.percent << "%\n";
+    if (v2_impact.priced_legs != 1 || std::fabs(v2_impact.percent - exact_impact) > 1e-6) {
+        std::cerr << "price impact mismatch" << std::endl;
+        return 1;
+    }
+
+    const size_t iterations = 5000000;
+    PoolState state;
+    double idle_ns = time_ns(iterations, [&]() { cache->snapshot(v2_pair, state); });
+    double impact_ns = time_ns(iterations / 5, [&]() { estimator.estimate(v2_legs, PoolVenue::UniswapV2); });
+
+    // A writer applying Syncs back to back while the reader copies
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        for (uint64_t block = 2; !stop.load(std::memory_order_relaxed); ++block) {
+            cache->apply_sync(v2_pair, block, 0, reserve_usdc + Uint256::from_u64(block), reserve_weth);
+        }
+    });
+    double contended_ns = time_ns(iterations, [&]() { cache->snapshot(v2_pair, state); });
+    stop = true;
+    writer.join();
+
+    std::cout << "snapshot (no writer):   " << idle_ns << " ns\n";
+    std::cout << "snapshot (with writer): " << contended_ns << " ns\n";
+    std::cout << "price impact (1 hop):   " << impact_ns << " ns\n";
+    std::cout << "log updates applied:    " << cache->log_update_count() << "\n";
+    return 0;
+}
@@ -0,0 +1,303 @@
+// /ws push feed: fan-out of analyses to many subscribers over loopback.
+//
+//   g++ -std=c++17 -O2 -Isrc bench_push_feed.cpp -lspdlog -lfmt -pthread -o bench_push_feed
+//   ./bench_push_feed
+//
+// Subscribers complete the RFC 6455 handshake against the real server;
+// every one must receive every published message with contiguous seq
+// numbers, and a ping must be answered. Reports the publisher's CPU time
+// per message (what the analysis workers pay, independent of how busy the
+// box is) and the end-to-end delivery rate.
+//
+// Then a subscriber stops reading: with drop_low its gaps must match its
+// drop count and favour MEDIUM over HIGH; with disconnect it must get a
+// 1008 close while publishing carries on.
+#include <atomic>
+#include <ctime>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "network/http_server.hpp"
+#include "network/push_feed.hpp"
+
+namespace {
+
+using namespace mev_shield;
+using boost::asio::ip::tcp;
+
+const unsigned short kPort = 18766;
+
+// HttpServer with only /ws, serving `feed`
+std::unique_ptr<HttpServer> serve(unsigned short port, const std::shared_ptr<PushFeed>& feed) {
+    auto server = std::make_unique<HttpServer>(port, 128, 2, [feed](const HttpRequest& request, HttpResponse& response) {
+        response.upgrade = request.path == "/ws";
+    });
+    server->set_upgrade_handler([feed](tcp::socket socket, std::string buffered, HttpServer::ConnectionSlot slot) {
+        feed->subscribe(std::move(socket), std::move(buffered), std::move(slot));
+    });
+    if (!server->start()) {
+        throw std::runtime_error("cannot listen");
+    }
+    return server;
+}
+
+tcp::socket subscribe(boost::asio::io_context& io, unsigned short port = kPort, int receive_buffer = 0) {
+    tcp::socket socket(io);
+    socket.open(tcp::v4());
+    if (receive_buffer > 0) {
+        socket.set_option(boost::asio::socket_base::receive_buffer_size(receive_buffer));
+    }
+    socket.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+    std::string request = "GET /ws HTTP/1.1\r\nHost: x\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+    boost::asio::streambuf response;
+    boost::asio::read_until(socket, response, "\r\n\r\n");
+    std::string head(boost::asio::buffers_begin(response.data()), boost::asio::buffers_end(response.data()));
+    if (head.find("101") == std::string::npos || head.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == std::string::npos) {
+        throw std::runtime_error("bad handshake: " + head);
+    }
+    return socket;
+}
+
+// Reads one server frame; returns its opcode
+uint8_t read_frame(tcp::socket& socket, std::string& payload) {
+    uint8_t header[10];
+    boost::asio::read(socket, boost::asio::buffer(header, 2));
+    uint64_t length = header[1] & 0x7F;
+    if (length == 126) {
+        boost::asio::read(socket, boost::asio::buffer(header + 2, 2));
+        length = (uint64_t{header[2]} << 8) | header[3];
+    } else if (length == 127) {
+        boost::asio::read(socket, boost::asio::buffer(header + 2, 8));
+        length = 0;
+        for (int i = 0; i < 8; ++i) {
+            length = (length << 8) | header[2 + i];
+        }
+    }
+    payload.resize(length);
+    boost::asio::read(socket, boost::asio::buffer(&payload[0], length));
+    return header[0] & 0x0F;
+}
+
+uint64_t field(const std::string& text, const char* key) {
+    size_t at = text.find(key);
+    return at == std::string::npos ? 0 : std::stoull(text.substr(at + std::strlen(key)));
+}
+
+TransactionAnalysis analysis_at(TransactionAnalysis::RiskLevel risk) {
+    TransactionAnalysis analysis;
+    analysis.risk_level = risk;
+    analysis.risk_reason = risk == TransactionAnalysis::HIGH ? TransactionAnalysis::Reason::HighProfit
+                                                              : TransactionAnalysis::Reason::MediumRisk;
+    analysis.risk_factors = TransactionAnalysis::DEX_SWAP | TransactionAnalysis::SANDWICHABLE;
+    analysis.estimated_mev_profit_eth = 0.25;
+    analysis.sandwich_frontrun_eth = 12.5;
+    return analysis;
+}
+
+// Publishes `count` messages, alternating MEDIUM and HIGH, to a subscriber
+// that is not reading, then reads until the last seq or a close frame.
+// Returns false on a protocol error.
+bool stall_then_drain(PushFeed& feed, tcp::socket& socket, size_t count, size_t& high, size_t& medium,
+                      uint64_t& gaps, bool& closed, uint16_t& close_code) {
+    TransactionInfo tx;
+    for (size_t i = 0; i < count; ++i) {
+        feed.publish(tx, analysis_at(i % 2 ? TransactionAnalysis::HIGH : TransactionAnalysis::MEDIUM));
+    }
+    std::string text;
+    uint64_t last = 0;
+    for (;;) {
+        uint8_t opcode = read_frame(socket, text);
+        if (opcode == 0x8) {
+            closed = true;
+            close_code = static_cast<uint16_t>((static_cast<uint8_t>(text[0]) << 8) | static_cast<uint8_t>(text[1]));
+            return true;
+        }
+        if (opcode != 0x1) {
+            return false;
+        }
+        uint64_t seq = field(text, "\"seq\":");
+        if (seq <= last) {
+            return false;
+        }
+        gaps += seq - last - 1;
+        last = seq;
+        (text.find("\"risk\":\"HIGH\"") != std::string::npos ? high : medium)++;
+        if (seq == feed.published_count()) {
+            return true;
+        }
+    }
+}
+
+double thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void send_masked(tcp::socket& socket, uint8_t opcode, const std::string& payload) {
+    std::string frame;
+    frame += static_cast<char>(0x80 | opcode);
+    frame += static_cast<char>(0x80 | payload.size());
+    const char mask[4] = {0x11, 0x22, 0x33, 0x44};
+    frame.append(mask, 4);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame += static_cast<char>(payload[i] ^ mask[i & 3]);
+    }
+    boost::asio::write(socket, boost::asio::buffer(frame));
+}
+
+} // namespace
+
+int main() {
+    const size_t subscribers = 64;
+    const size_t messages = 20000;
+    const size_t publishers = 4;
+
+    PushFeed::Options options;
+    options.queue_messages = messages;       // nobody may drop in the delivery check
+    auto feed = std::make_shared<PushFeed>(options);
+    std::unique_ptr<HttpServer> server = serve(kPort, feed);
+
+    boost::asio::io_context io;
+    std::vector<tcp::socket> sockets;
+    for (size_t i = 0; i < subscribers; ++i) {
+        sockets.push_back(subscribe(io));
+    }
+    while (feed->subscriber_count() < subscribers) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (server->connection_count() != subscribers) {
+        std::cerr << "upgraded sockets must hold their connection slot: "
+                  << server->connection_count() << " counted" << std::endl;
+        return 1;
+    }
+
+    std::string payload;
+    send_masked(sockets[0], 0x9, "are you there");
+    if (read_frame(sockets[0], payload) != 0xA || payload != "are you there") {
+        std::cerr << "ping not answered" << std::endl;
+        return 1;
+    }
+
+    // Receivers check seq 1, 2, 3, ... and value_eth 0, 1, 2, ... per publisher
+    std::atomic<size_t> failures{0};
+    std::vector<std::thread> receivers;
+    for (auto& socket : sockets) {
+        receivers.emplace_back([&]() {
+            std::vector<uint64_t> next(publishers, 0);
+            std::string text;
+            for (size_t i = 0; i < messages; ++i) {
+                if (read_frame(socket, text) != 0x1 || field(text, "\"seq\":") != i + 1) {
+                    ++failures;
+                    return;
+                }
+                size_t hash_at = text.find("\"hash\":\"0x") + 10;
+                size_t publisher = std::stoul(text.substr(hash_at, 2), nullptr, 16);
+                size_t value_at = text.find("\"value_eth\":") + 12;
+                uint64_t value = std::stoull(text.substr(value_at));
+                if (publisher >= publishers || value != next[publisher]++) {
+                    ++failures;
+                    return;
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> publish_cpu_ns{0};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < publishers; ++p) {
+        threads.emplace_back([&, p]() {
+            TransactionInfo tx;
+            tx.hash.bytes[0] = static_cast<uint8_t>(p);
+            TransactionAnalysis analysis = analysis_at(TransactionAnalysis::HIGH);
+            double cpu_start = thread_cpu_ns();
+            for (size_t i = 0; i < messages / publishers; ++i) {
+                tx.eth_value = static_cast<double>(i);
+                feed->publish(tx, analysis);
+            }
+            publish_cpu_ns += static_cast<uint64_t>(thread_cpu_ns() - cpu_start);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& receiver : receivers) {
+        receiver.join();
+    }
+    double delivered_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failures != 0) {
+        std::cerr << failures << " subscribers saw missing or reordered messages" << std::endl;
+        return 1;
+    }
+
+    std::cout << subscribers << " subscribers, " << messages << " messages from " << publishers << " threads\n";
+    std::cout << "publish:  " << publish_cpu_ns / messages << " ns CPU per message ("
+              << publish_cpu_ns / messages / subscribers << " ns per subscriber)\n";
+    std::cout << "delivery: " << static_cast<uint64_t>(messages * subscribers / delivered_s)
+              << " frames/s to subscribers\n";
+
+    feed->close_all();
+    if (read_frame(sockets[1], payload) != 0x8) {
+        std::cerr << "expected a close frame" << std::endl;
+        return 1;
+    }
+    server->stop();
+
+    // Slow consumers: 40k messages of ~700 bytes overrun any socket buffer
+    const size_t flood = 40000;
+    {
+        PushFeed::Options slow;
+        slow.queue_messages = 256;
+        slow.overflow = OverflowPolicy::DropLowestRisk;
+        auto drop_feed = std::make_shared<PushFeed>(slow);
+        std::unique_ptr<HttpServer> drop_server = serve(kPort + 1, drop_feed);
+        tcp::socket stalled = subscribe(io, kPort + 1, 4096);
+        while (drop_feed->subscriber_count() < 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        size_t high = 0, medium = 0;
+        uint64_t gaps = 0;
+        bool closed = false;
+        uint16_t code = 0;
+        uint64_t dropped_before = drop_feed->subscriber_stats()[0].dropped;
+        bool ok = stall_then_drain(*drop_feed, stalled, flood, high, medium, gaps, closed, code);
+        std::cout << "drop_low:   " << high << " HIGH and " << medium << " MEDIUM delivered, " << gaps
+                  << " seq gaps, " << drop_feed->dropped_count() << " dropped\n";
+        if (!ok || closed || dropped_before != 0 || gaps != drop_feed->dropped_count() ||
+            gaps == 0 || high <= medium || high + medium + gaps != flood) {
+            std::cerr << "drop_low policy mismatch" << std::endl;
+            return 1;
+        }
+        drop_server->stop();
+    }
+    {
+        PushFeed::Options slow;
+        slow.queue_messages = 256;
+        slow.overflow = OverflowPolicy::Disconnect;
+        auto cut_feed = std::make_shared<PushFeed>(slow);
+        std::unique_ptr<HttpServer> cut_server = serve(kPort + 2, cut_feed);
+        tcp::socket stalled = subscribe(io, kPort + 2, 4096);
+        while (cut_feed->subscriber_count() < 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        size_t high = 0, medium = 0;
+        uint64_t gaps = 0;
+        bool closed = false;
+        uint16_t code = 0;
+        bool ok = stall_then_drain(*cut_feed, stalled, flood, high, medium, gaps, closed, code);
+        std::cout << "disconnect: closed with " << code << " after " << high + medium << " messages, "
+                  << cut_feed->slow_disconnect_count() << " slow disconnect(s)\n";
+        if (!ok || !closed || code != 1008 || gaps != 0 || cut_feed->slow_disconnect_count() != 1) {
+            std::cerr << "disconnect policy mismatch" << std::endl;
+            return 1;
+        }
+        cut_server->stop();
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Stage latency recording: cost of StageLatency::record and of a timed
+// scope, and the merged percentiles against exact ones.
+//
+//   g++ -std=c++17 -O2 -Isrc bench_stage_latency.cpp -pthread -o bench_stage_latency
+//   ./bench_stage_latency
+//
+// Four threads record a log-normal latency mix into their own histograms;
+// the merged p50/p99/p99.9 must be within the histogram's 1/64 bucket
+// width of the exact order statistics.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "common/latency_histogram.hpp"
+
+namespace {
+
+using namespace mev_shield;
+
+template <typename Fn>
+double time_ns(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+uint64_t exact(const std::vector<uint64_t>& sorted, double quantile) {
+    size_t rank = static_cast<size_t>(std::ceil(quantile * sorted.size()));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+bool close(uint64_t reported, uint64_t expected) {
+    return reported >= expected && reported <= expected + expected / 64 + 1;
+}
+
+} // namespace
+
+int main() {
+    const size_t threads = 4;
+    const size_t per_thread = 250000;
+    std::vector<std::vector<uint64_t>> samples(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        std::mt19937_64 rng(t + 1);
+        std::lognormal_distribution<double> latency(std::log(20000.0), 1.2);   // ~20 us median
+        for (size_t i = 0; i < per_thread; ++i) {
+            samples[t].push_back(static_cast<uint64_t>(latency(rng)));
+        }
+    }
+
+    StageLatency& stages = StageLatency::get_instance();
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t]() {
+            for (uint64_t ns : samples[t]) {
+                stages.record(Stage::Analyze, ns);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const auto& thread_samples : samples) {
+        all.insert(all.end(), thread_samples.begin(), thread_samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    LatencySummary summary = stages.summary(Stage::Analyze);
+    std::cout << "n=" << summary.count << " p50=" << summary.p50_ns << " (" << exact(all, 0.5)
+              << ") p99=" << summary.p99_ns << " (" << exact(all, 0.99)
+              << ") p99.9=" << summary.p999_ns << " (" << exact(all, 0.999) << ") ns\n";
+    if (summary.count != all.size() || summary.max_ns != all.back() ||
+        !close(summary.p50_ns, exact(all, 0.5)) || !close(summary.p99_ns, exact(all, 0.99)) ||
+        !close(summary.p999_ns, exact(all, 0.999))) {
+        std::cerr << "percentile mismatch" << std::endl;
+        return 1;
+    }
+
+    const size_t iterations = 10000000;
+    double record_ns = time_ns(iterations, [&](size_t i) { stages.record(Stage::Parse, i & 0xFFFF); });
+    double timer_ns = time_ns(iterations, [](size_t) { StageTimer timer(Stage::Decode); });
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kStageCount; ++i) {
+        stages.summary(static_cast<Stage>(i));
+    }
+    double merge_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "record:           " << record_ns << " ns\n";
+    std::cout << "timed scope:      " << timer_ns << " ns\n";
+    std::cout << "merge all stages: " << merge_us << " us (" << threads + 1 << " thread sets)\n";
+    return 0;
+}
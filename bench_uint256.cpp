@@ -0,0 +1,135 @@
+// Compares Uint256 wei handling against the old string path
+// (std::stoull on the hex quantity, then / 1e18).
+//
+//   g++ -std=c++17 -O2 -Isrc bench_uint256.cpp -o bench_uint256
+//   ./bench_uint256
+//
+// The value mix is drawn from typical mempool traffic: mostly dust and
+// sub-ether swaps, plus whale trades above 2^64 wei (~18.4 ETH) that the
+// string path cannot represent.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "common/uint256.hpp"
+
+namespace {
+
+// The pre-Uint256 RiskEngine::hex_to_eth
+double string_hex_to_eth(const std::string& hex_value) {
+    try {
+        if (hex_value.empty() || hex_value == "0x0") return 0.0;
+        uint64_t wei = std::stoull(hex_value, nullptr, 16);
+        return static_cast<double>(wei) / 1e18;
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+}
+
+std::vector<std::string> make_values(size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<std::string> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        mev_shield::Uint256 wei;
+        switch (rng() % 10) {
+            case 0: break;                                                  // zero-value calls
+            case 1: wei.limbs[0] = rng() % 100000000000000000ULL; break;    // < 0.1 ETH
+            case 2: case 3: case 4: case 5: case 6:
+                wei.limbs[0] = rng() % (10 * mev_shield::kWeiPerEther); break;
+            default:                                                        // 18-10000 ETH
+                wei = mev_shield::ether_to_wei(18 + rng() % 10000) +
+                      mev_shield::Uint256::from_u64(rng() % mev_shield::kWeiPerEther);
+                break;
+        }
+        values.push_back(wei.to_hex());
+    }
+    return values;
+}
+
+template <typename Fn>
+double time_ns(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main() {
+    const size_t kValues = 4096;
+    const size_t kRounds = 500;
+    std::vector<std::string> values = make_values(kValues);
+
+    // Correctness first: how many values does the string path lose?
+    size_t lost = 0;
+    double max_error = 0.0;
+    for (const auto& value : values) {
+        mev_shield::Uint256 wei;
+        mev_shield::Uint256::from_hex(value.data(), value.size(), wei);
+        double exact = mev_shield::wei_to_ether(wei);
+        double legacy = string_hex_to_eth(value);
+        if (exact > 0.0 && legacy == 0.0) {
+            lost++;
+        } else if (exact > 0.0) {
+            max_error = std::max(max_error, std::abs(legacy - exact) / exact);
+        }
+    }
+    std::cout << "Values: " << kValues << ", zeroed by stoull path: " << lost
+              << " (" << 100.0 * lost / kValues << "%), max rel. error otherwise: "
+              << max_error << std::endl;
+
+    double sink = 0.0;
+    double string_ns = time_ns(kRounds, [&] {
+        for (const auto& value : values) {
+            sink += string_hex_to_eth(value);
+        }
+    });
+    double uint_ns = time_ns(kRounds, [&] {
+        for (const auto& value : values) {
+            mev_shield::Uint256 wei;
+            mev_shield::Uint256::from_hex(value.data(), value.size(), wei);
+            sink += mev_shield::wei_to_ether(wei);
+        }
+    });
+
+    // Arithmetic on parsed words, as used for amount/reserve math
+    std::vector<mev_shield::Uint256> words(kValues);
+    for (size_t i = 0; i < kValues; ++i) {
+        mev_shield::Uint256::from_hex(values[i].data(), values[i].size(), words[i]);
+    }
+    const mev_shield::Uint256 reserve = mev_shield::ether_to_wei(50000);
+    const mev_shield::Uint256 fee = mev_shield::Uint256::from_u64(997);
+    mev_shield::Uint256 acc;
+    double mul_div_ns = time_ns(kRounds, [&] {
+        for (const auto& amount : words) {
+            // x*997*R / (R*1000 + x*997): one constant-product quote
+            mev_shield::Uint256 in_with_fee = amount * fee;
+            acc = acc + (in_with_fee * reserve) /
+                        (reserve * mev_shield::Uint256::from_u64(1000) + in_with_fee);
+        }
+    });
+    char digits[78];
+    size_t digit_count = 0;
+    double decimal_ns = time_ns(kRounds, [&] {
+        for (const auto& amount : words) {
+            digit_count += amount.to_decimal(digits);
+        }
+    });
+
+    double ops = static_cast<double>(kValues * kRounds);
+    std::cout << "stoull hex_to_eth:     " << string_ns / ops << " ns/value" << std::endl;
+    std::cout << "Uint256 parse + ether: " << uint_ns / ops << " ns/value ("
+              << string_ns / uint_ns << "x)" << std::endl;
+    std::cout << "Uint256 AMM quote:     " << mul_div_ns / ops << " ns/quote" << std::endl;
+    std::cout << "Uint256 to_decimal:    " << decimal_ns / ops << " ns/value" << std::endl;
+    std::cout << "(checksum " << sink << " " << acc.limbs[0] << " " << digit_count << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,306 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "common/eth_types.hpp"
+#include "common/keccak.hpp"
+#include "common/uint256.hpp"
+
+namespace mev_shield {
+namespace abi {
+
+// Zero-copy decoding of Solidity ABI calldata into typed structs.
+//
+// A function is declared once as a struct with its canonical signature and
+// one member per argument, in order:
+//
+//   struct Transfer {
+//       static constexpr char kSignature[] = "transfer(address,uint256)";
+//       Address to;
+//       Uint256 amount;
+//       bool decode(ByteSpan args) { return decode_args(args, to, amount); }
+//   };
+//
+// The selector is keccak256(kSignature) computed at compile time, and
+// dispatch<Functions...>() looks it up in a perfect hash built at compile
+// time, so matching a transaction costs one multiply, one table load and
+// one compare. Dynamic arguments (arrays, bytes) are views into calldata.
+
+constexpr size_t kWordSize = 32;
+
+template <typename Function>
+constexpr uint32_t kSelectorOf = keccak::selector(Function::kSignature);
+
+inline uint32_t read_selector(ByteSpan calldata) {
+    return (uint32_t{calldata.data[0]} << 24) | (uint32_t{calldata.data[1]} << 16) |
+           (uint32_t{calldata.data[2]} << 8) | uint32_t{calldata.data[3]};
+}
+
+// Word at byte offset, or nullptr if it runs past the end
+inline const uint8_t* word_at(ByteSpan args, size_t offset) {
+    if (offset > args.size || args.size - offset < kWordSize) {
+        return nullptr;
+    }
+    return args.data + offset;
+}
+
+// Small integers (offsets, lengths, uint24 fees): the upper 24 bytes must be zero
+inline bool read_size(const uint8_t* word, size_t& out) {
+    uint64_t high = 0;
+    for (size_t i = 0; i < 24; ++i) {
+        high |= word[i];
+    }
+    if (high != 0) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (size_t i = 24; i < kWordSize; ++i) {
+        value = (value << 8) | word[i];
+    }
+    out = static_cast<size_t>(value);
+    return true;
+}
+
+inline Address address_from_word(const uint8_t* word) {
+    Address address;
+    for (size_t i = 0; i < Address::kSize; ++i) {
+        address.bytes[i] = word[12 + i];
+    }
+    return address;
+}
+
+// address[] left in calldata; elements are decoded on access
+struct AddressList {
+    const uint8_t* words = nullptr;
+    size_t size = 0;
+
+    Address operator[](size_t i) const { return address_from_word(words + i * kWordSize); }
+    Address front() const { return (*this)[0]; }
+    Address back() const { return (*this)[size - 1]; }
+};
+
+// Resolves the head slot of a dynamic argument to its tail: the length word
+// and `element_size * length` bytes after it, all inside `args`
+inline bool dynamic_tail(ByteSpan args, size_t slot, size_t element_size,
+                         const uint8_t*& data, size_t& length) {
+    const uint8_t* head = word_at(args, slot * kWordSize);
+    size_t offset = 0;
+    const uint8_t* length_word = nullptr;
+    if (!head || !read_size(head, offset) || !(length_word = word_at(args, offset)) ||
+        !read_size(length_word, length)) {
+        return false;
+    }
+    size_t available = args.size - offset - kWordSize;
+    if (length > available / (element_size ? element_size : 1)) {
+        return false;
+    }
+    data = length_word + kWordSize;
+    return true;
+}
+
+// Any other argument type is a struct for a dynamic tuple (one holding
+// bytes or arrays): its head slot is an offset, and the struct decodes its
+// own members relative to that point
+template <typename T>
+struct Codec {
+    static bool decode(ByteSpan args, size_t slot, T& out) {
+        const uint8_t* head = word_at(args, slot * kWordSize);
+        size_t offset = 0;
+        if (!head || !read_size(head, offset) || offset > args.size) {
+            return false;
+        }
+        return out.decode(ByteSpan{args.data + offset, args.size - offset});
+    }
+};
+
+// bytes[]: element offsets are relative to the first offset word
+struct BytesList {
+    const uint8_t* heads = nullptr;
+    size_t size = 0;
+    size_t extent = 0;           // bytes available from `heads` onwards
+
+    bool at(size_t i, ByteSpan& out) const {
+        return i < size && dynamic_tail(ByteSpan{heads, extent}, i, 1, out.data, out.size);
+    }
+};
+
+template <>
+struct Codec<Uint256> {
+    static bool decode(ByteSpan args, size_t slot, Uint256& out) {
+        const uint8_t* word = word_at(args, slot * kWordSize);
+        if (!word) {
+            return false;
+        }
+        out = Uint256::from_be_bytes(word);
+        return true;
+    }
+};
+
+template <>
+struct Codec<Address> {
+    static bool decode(ByteSpan args, size_t slot, Address& out) {
+        const uint8_t* word = word_at(args, slot * kWordSize);
+        if (!word) {
+            return false;
+        }
+        out = address_from_word(word);
+        return true;
+    }
+};
+
+template <>
+struct Codec<bool> {
+    static bool decode(ByteSpan args, size_t slot, bool& out) {
+        const uint8_t* word = word_at(args, slot * kWordSize);
+        size_t value = 0;
+        if (!word || !read_size(word, value) || value > 1) {
+            return false;
+        }
+        out = value != 0;
+        return true;
+    }
+};
+
+// uint8..uint64 arguments such as V3 fee tiers
+template <>
+struct Codec<uint64_t> {
+    static bool decode(ByteSpan args, size_t slot, uint64_t& out) {
+        const uint8_t* word = word_at(args, slot * kWordSize);
+        size_t value = 0;
+        if (!word || !read_size(word, value)) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+};
+
+template <>
+struct Codec<AddressList> {
+    static bool decode(ByteSpan args, size_t slot, AddressList& out) {
+        return dynamic_tail(args, slot, kWordSize, out.words, out.size);
+    }
+};
+
+// `bytes`
+template <>
+struct Codec<ByteSpan> {
+    static bool decode(ByteSpan args, size_t slot, ByteSpan& out) {
+        return dynamic_tail(args, slot, 1, out.data, out.size);
+    }
+};
+
+template <>
+struct Codec<BytesList> {
+    static bool decode(ByteSpan args, size_t slot, BytesList& out) {
+        if (!dynamic_tail(args, slot, kWordSize, out.heads, out.size)) {
+            return false;
+        }
+        out.extent = static_cast<size_t>(args.data + args.size - out.heads);
+        return true;
+    }
+};
+
+// Decodes consecutive head slots into `out...`, left to right
+template <typename... Ts>
+bool decode_args(ByteSpan args, Ts&... out) {
+    size_t slot = 0;
+    return (Codec<Ts>::decode(args, slot++, out) && ...);
+}
+
+// Compile-time perfect hash from selector to function index
+struct HashParams {
+    uint32_t multiplier;
+    unsigned bits;  // 0 when no collision-free multiplier exists
+};
+
+constexpr uint32_t hash_slot(uint32_t selector, HashParams params) {
+    return params.bits == 0 ? 0 : static_cast<uint32_t>(selector * params.multiplier) >> (32 - params.bits);
+}
+
+template <size_t N>
+constexpr bool collision_free(const std::array<uint32_t, N>& selectors, HashParams params) {
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i + 1; j < N; ++j) {
+            if (hash_slot(selectors[i], params) == hash_slot(selectors[j], params)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Smallest table, then first odd multiplier, without collisions
+template <size_t N>
+constexpr HashParams find_hash_params(const std::array<uint32_t, N>& selectors) {
+    unsigned bits = 1;
+    while ((size_t{1} << bits) < N) {
+        ++bits;
+    }
+    for (; bits <= 12; ++bits) {
+        for (uint32_t multiplier = 1; multiplier < 4096; multiplier += 2) {
+            HashParams params{multiplier * 0x9E3779B1u, bits};
+            if (collision_free(selectors, params)) {
+                return params;
+            }
+        }
+    }
+    return HashParams{0, 0};
+}
+
+// Slot -> function index + 1 (0 = empty)
+template <size_t Size, size_t N>
+constexpr std::array<uint8_t, Size> build_slot_table(const std::array<uint32_t, N>& selectors,
+                                                     HashParams params) {
+    std::array<uint8_t, Size> slots{};
+    for (size_t i = 0; i < N; ++i) {
+        slots[hash_slot(selectors[i], params)] = static_cast<uint8_t>(i + 1);
+    }
+    return slots;
+}
+
+template <typename... Functions>
+struct SelectorTable {
+    static constexpr std::array<uint32_t, sizeof...(Functions)> kSelectors = {kSelectorOf<Functions>...};
+    static constexpr HashParams kParams = find_hash_params(kSelectors);
+    static_assert(kParams.bits != 0, "duplicate selectors in dispatch list");
+    static constexpr size_t kSize = size_t{1} << kParams.bits;
+    static constexpr std::array<uint8_t, kSize> kSlots = build_slot_table<kSize>(kSelectors, kParams);
+
+    // Function index for `selector`, or -1
+    static int find(uint32_t selector) {
+        uint8_t entry = kSlots[hash_slot(selector, kParams)];
+        return entry != 0 && kSelectors[entry - 1] == selector ? entry - 1 : -1;
+    }
+};
+
+template <typename Function, typename Visitor>
+bool decode_and_visit(ByteSpan args, Visitor& visitor) {
+    Function call;
+    if (!call.decode(args)) {
+        return false;
+    }
+    return visitor(call);
+}
+
+// Decodes `calldata` as whichever of Functions its selector names and hands
+// the typed call to `visitor` (an overload set returning bool). Returns
+// false for unknown selectors or malformed arguments.
+template <typename... Functions, typename Visitor>
+bool dispatch(ByteSpan calldata, Visitor& visitor) {
+    using Table = SelectorTable<Functions...>;
+    using Thunk = bool (*)(ByteSpan, Visitor&);
+    static constexpr Thunk kThunks[] = {&decode_and_visit<Functions, Visitor>...};
+
+    if (calldata.size < 4) {
+        return false;
+    }
+    int index = Table::find(read_selector(calldata));
+    if (index < 0) {
+        return false;
+    }
+    return kThunks[index](ByteSpan{calldata.data + 4, calldata.size - 4}, visitor);
+}
+
+} // namespace abi
+} // namespace mev_shield
@@ -0,0 +1,129 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "analytics/router_table.hpp"
+#include "analytics/transaction.hpp"
+
+namespace mev_shield {
+
+// Decoded transactions laid out column-wise for RiskEngine::analyze_batch.
+// Rows point at their TransactionInfo (for calldata), which must outlive
+// the analysis. Columns are reserved up front; push() never allocates.
+class TransactionBatch {
+public:
+    explicit TransactionBatch(size_t capacity = 1024) : capacity_(capacity > 0 ? capacity : 1) {
+        tx_.reserve(capacity_);
+        router_.reserve(capacity_);
+        selector_.reserve(capacity_);
+        eth_value_.reserve(capacity_);
+    }
+
+    size_t size() const { return tx_.size(); }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return tx_.empty(); }
+    bool full() const { return tx_.size() == capacity_; }
+
+    void clear() {
+        tx_.clear();
+        router_.clear();
+        selector_.clear();
+        eth_value_.clear();
+    }
+
+    // False when the batch is full
+    bool push(const TransactionInfo& tx, const RouterTable& routers) {
+        if (full()) {
+            return false;
+        }
+        uint32_t selector = 0;
+        if (tx.calldata.size >= 4) {
+            const uint8_t* data = tx.calldata.data;
+            selector = (uint32_t{data[0]} << 24) | (uint32_t{data[1]} << 16) |
+                       (uint32_t{data[2]} << 8) | uint32_t{data[3]};
+        }
+        tx_.push_back(&tx);
+        router_.push_back(tx.has_to ? routers.find(tx.to) : RouterTable::kNotFound);
+        selector_.push_back(selector);
+        eth_value_.push_back(tx.eth_value);
+        return true;
+    }
+
+    const TransactionInfo& tx(size_t row) const { return *tx_[row]; }
+    const RouterTable::RouterId* router() const { return router_.data(); }
+    const uint32_t* selector() const { return selector_.data(); }    // 0 without calldata
+    const double* eth_value() const { return eth_value_.data(); }
+
+private:
+    size_t capacity_;
+    std::vector<const TransactionInfo*> tx_;
+    std::vector<RouterTable::RouterId> router_;
+    std::vector<uint32_t> selector_;
+    std::vector<double> eth_value_;
+};
+
+// Results of analyze_batch, one row per TransactionBatch row. Plain columns
+// so threshold checks over a whole block run as straight loops; a row is
+// turned into a TransactionAnalysis only when it has to be reported.
+struct AnalysisBatch {
+    std::vector<uint8_t> risk_level;         // TransactionAnalysis::RiskLevel
+    std::vector<uint8_t> is_dex_swap;
+    std::vector<uint8_t> high_slippage;
+    std::vector<uint8_t> opportunity;        // RiskEngine::analyze_opportunity
+    std::vector<uint8_t> swap_legs;
+    std::vector<uint8_t> missing_legs;
+    std::vector<double> mev_profit_eth;
+    std::vector<double> sandwich_frontrun_eth;
+    std::vector<double> slippage_percent;
+    std::vector<double> swap_notional_eth;
+
+    explicit AnalysisBatch(size_t capacity = 1024) {
+        resize(capacity);
+        rows_ = 0;
+    }
+
+    size_t size() const { return rows_; }
+
+    // Sizes every column to `rows` and zeroes them; only allocates when
+    // `rows` exceeds every earlier batch
+    void reset(size_t rows) {
+        if (rows > risk_level.size()) {
+            resize(rows);
+        }
+        rows_ = rows;
+        zero(risk_level);
+        zero(is_dex_swap);
+        zero(high_slippage);
+        zero(opportunity);
+        zero(swap_legs);
+        zero(missing_legs);
+        zero(mev_profit_eth);
+        zero(sandwich_frontrun_eth);
+        zero(slippage_percent);
+        zero(swap_notional_eth);
+    }
+
+private:
+    size_t rows_ = 0;
+
+    void resize(size_t rows) {
+        risk_level.resize(rows);
+        is_dex_swap.resize(rows);
+        high_slippage.resize(rows);
+        opportunity.resize(rows);
+        swap_legs.resize(rows);
+        missing_legs.resize(rows);
+        mev_profit_eth.resize(rows);
+        sandwich_frontrun_eth.resize(rows);
+        slippage_percent.resize(rows);
+        swap_notional_eth.resize(rows);
+    }
+
+    template <typename T>
+    void zero(std::vector<T>& column) {
+        std::fill(column.begin(), column.begin() + static_cast<std::ptrdiff_t>(rows_), T{});
+    }
+};
+
+} // namespace mev_shield
@@ -0,0 +1,243 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "analytics/transaction.hpp"
+#include "analytics/transaction_analysis.hpp"
+#include "common/epoch.hpp"
+#include "common/ring_buffer.hpp"
+
+namespace mev_shield {
+
+// A MEDIUM or HIGH analysis together with the transaction it is about
+struct Opportunity {
+    Hash32 hash;
+    Address from;
+    Address to;
+    bool has_to = false;
+    double eth_value = 0.0;
+    uint64_t seen_ms = 0;            // wall clock, for display
+    uint64_t id = 0;                 // assigned in arrival order once stored
+    TransactionAnalysis analysis;
+
+    // Without the calldata span, which dies with the PendingTransaction
+    TransactionInfo tx() const {
+        TransactionInfo info;
+        info.hash = hash;
+        info.from = from;
+        info.to = to;
+        info.has_to = has_to;
+        info.eth_value = eth_value;
+        return info;
+    }
+};
+
+static_assert(std::is_trivially_copyable<Opportunity>::value, "Opportunity must stay a plain record");
+
+// Immutable view served to API readers
+struct OpportunitySnapshot {
+    uint64_t version = 0;            // moves whenever the contents change
+    std::vector<Opportunity> entries;    // newest first, so ids descend
+};
+
+// Recent MEDIUM and HIGH analyses for /api/opportunities.
+//
+// Analysis workers record() into a lock-free ring and never wait. One
+// maintenance thread drains the ring every kTick into a bounded window
+// (the newest `capacity` entries), expires entries older than the TTL
+// with a hashed timing wheel, and when anything changed publishes a new
+// snapshot through an RcuCell. Readers pin the current snapshot with an
+// Epoch::Guard: no lock, no copy, and no effect on the writers, however
+// many API polls run at once. Snapshots lag the pipeline by at most kTick.
+class OpportunityStore {
+public:
+    static constexpr std::chrono::milliseconds kTick{50};
+    // Intake ring slots: several windows' worth, as a full ring refuses the
+    // newest entries until the next drain
+    static constexpr size_t kMinIntake = 4096;
+
+    OpportunityStore(size_t capacity, std::chrono::seconds ttl)
+        : capacity_(round_up_pow2(capacity))
+        , wheel_(static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(ttl) / kTick) + 2)
+        , ttl_ticks_(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(ttl) / kTick))
+        , incoming_(std::max(capacity_ * 4, kMinIntake))
+        , window_(capacity_)
+        , snapshot_(std::make_unique<OpportunitySnapshot>()) {}
+
+    ~OpportunityStore() {
+        stop();
+    }
+
+    OpportunityStore(const OpportunityStore&) = delete;
+    OpportunityStore& operator=(const OpportunityStore&) = delete;
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        last_tick_ = current_tick();
+        worker_ = std::thread([this]() { maintain(); });
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // Analysis worker threads. LOW results are ignored; a full ring drops
+    // the entry rather than wait.
+    void record(const TransactionInfo& tx, const TransactionAnalysis& analysis) {
+        if (analysis.risk_level == TransactionAnalysis::LOW) {
+            return;
+        }
+        uint64_t seen_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        bool queued = incoming_.try_push_with([&](Opportunity& slot) {
+            slot.hash = tx.hash;
+            slot.from = tx.from;
+            slot.to = tx.to;
+            slot.has_to = tx.has_to;
+            slot.eth_value = tx.eth_value;
+            slot.seen_ms = seen_ms;
+            slot.analysis = analysis;
+        });
+        if (!queued) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread. The snapshot stays valid while `guard` lives.
+    const OpportunitySnapshot& snapshot(const Epoch::Guard& guard) const {
+        return snapshot_.read(guard);
+    }
+
+    size_t capacity() const { return capacity_; }
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t expired_count() const { return expired_.load(std::memory_order_relaxed); }
+    size_t live_count() const { return live_.load(std::memory_order_relaxed); }
+
+private:
+    // Window slot: the entry with id `id`, if `live`
+    struct Entry {
+        Opportunity opportunity;
+        uint64_t id = 0;
+        bool live = false;
+    };
+
+    size_t capacity_;
+    std::vector<std::vector<uint64_t>> wheel_;   // ids by expiry tick modulo size
+    uint64_t ttl_ticks_;
+    RingBuffer<Opportunity> incoming_;
+    std::vector<Entry> window_;                  // indexed by id & (capacity_ - 1)
+    uint64_t next_id_ = 1;
+    uint64_t last_tick_ = 0;
+    uint64_t last_version_ = 0;
+    RcuCell<OpportunitySnapshot> snapshot_;
+
+    std::thread worker_;
+    std::mutex mutex_;                           // only for the worker's sleep
+    std::condition_variable cv_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> expired_{0};
+    std::atomic<size_t> live_{0};
+
+    static uint64_t current_tick() {
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch() / kTick);
+    }
+
+    void maintain() {
+        while (running_.load()) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_for(lock, kTick, [this]() { return !running_.load(); });
+            }
+            // Expire first: after a stall, expire() sweeps every bucket,
+            // including the ones the freshly drained entries go into
+            uint64_t now = current_tick();
+            bool changed = expire(now);
+            changed |= drain(now);
+            if (changed) {
+                publish();
+            } else {
+                snapshot_.reclaim();
+            }
+        }
+    }
+
+    bool drain(uint64_t now) {
+        const size_t mask = capacity_ - 1;
+        uint64_t expiry = now + ttl_ticks_;
+        bool changed = false;
+        while (incoming_.try_pop_with([&](Opportunity& opportunity) {
+            uint64_t id = next_id_++;
+            Entry& entry = window_[id & mask];
+            if (entry.live) {
+                live_.fetch_sub(1, std::memory_order_relaxed);   // evicted by capacity
+            }
+            entry.opportunity = opportunity;
+            entry.opportunity.id = id;
+            entry.id = id;
+            entry.live = true;
+            live_.fetch_add(1, std::memory_order_relaxed);
+            wheel_[expiry % wheel_.size()].push_back(id);
+        })) {
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Empties every wheel bucket whose tick has passed. An id whose slot
+    // was since reused by a newer entry is simply skipped.
+    bool expire(uint64_t now) {
+        const size_t mask = capacity_ - 1;
+        bool changed = false;
+        // After a stall longer than a full turn every bucket is due once
+        uint64_t from = std::max(last_tick_ + 1, now >= wheel_.size() ? now - wheel_.size() + 1 : 0);
+        for (uint64_t tick = from; tick <= now; ++tick) {
+            std::vector<uint64_t>& bucket = wheel_[tick % wheel_.size()];
+            for (uint64_t id : bucket) {
+                Entry& entry = window_[id & mask];
+                if (entry.live && entry.id == id) {
+                    entry.live = false;
+                    live_.fetch_sub(1, std::memory_order_relaxed);
+                    expired_.fetch_add(1, std::memory_order_relaxed);
+                    changed = true;
+                }
+            }
+            bucket.clear();
+        }
+        last_tick_ = now;
+        return changed;
+    }
+
+    void publish() {
+        const size_t mask = capacity_ - 1;
+        auto next = std::make_unique<OpportunitySnapshot>();
+        next->version = last_version_ + 1;
+        next->entries.reserve(live_.load(std::memory_order_relaxed));
+        uint64_t oldest = next_id_ > capacity_ ? next_id_ - capacity_ : 1;
+        for (uint64_t id = next_id_; id-- > oldest;) {
+            const Entry& entry = window_[id & mask];
+            if (entry.live && entry.id == id) {
+                next->entries.push_back(entry.opportunity);
+            }
+        }
+        last_version_ = next->version;
+        snapshot_.publish(std::move(next));
+    }
+};
+
+} // namespace mev_shield
@@ -0,0 +1,492 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "common/config_loader.hpp"
+#include "common/eth_types.hpp"
+#include "common/keccak.hpp"
+#include "common/logger.hpp"
+#include "common/ring_buffer.hpp"
+#include "common/uint256.hpp"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mev_shield {
+
+// Which deployment a pool belongs to; V2 forks share the pair contract but
+// not the factory, so they resolve to different addresses
+enum class PoolVenue : uint8_t { UniswapV2, SushiSwap, UniswapV3 };
+
+// Everything price impact needs from one pool. V2 pairs fill the reserves,
+// V3 pools the slot0 price and in-range liquidity. Trivially copyable so it
+// can travel through the seqlock as plain words.
+struct PoolState {
+    PoolVenue venue = PoolVenue::UniswapV2;
+    uint32_t fee = 3000;              // hundredths of a bip
+    int32_t tick = 0;                 // V3
+    uint32_t log_index = 0;           // position of the last applied log
+    uint64_t block_number = 0;        // 0 until the first log; bootstrap reads "latest"
+    Address token0;
+    Address token1;
+    Uint256 reserve0;                 // V2
+    Uint256 reserve1;                 // V2
+    Uint256 sqrt_price_x96;           // V3
+    Uint256 liquidity;                // V3
+
+    bool is_v3() const { return venue == PoolVenue::UniswapV3; }
+
+    // Reserves for a swap from `token_in`, as doubles in raw token units.
+    // V3 pools report their virtual reserves in the current range:
+    // x = L / sqrt(P), y = L * sqrt(P). False if the pool does not hold
+    // `token_in` or is empty.
+    bool reserves_for(const Address& token_in, double& reserve_in, double& reserve_out) const {
+        bool zero_for_one = token_in == token0;
+        if (!zero_for_one && token_in != token1) {
+            return false;
+        }
+        double reserve_0 = 0.0;
+        double reserve_1 = 0.0;
+        if (is_v3()) {
+            double sqrt_price = sqrt_price_x96.to_double() / 79228162514264337593543950336.0;  // 2^96
+            double l = liquidity.to_double();
+            if (sqrt_price <= 0.0 || l <= 0.0) {
+                return false;
+            }
+            reserve_0 = l / sqrt_price;
+            reserve_1 = l * sqrt_price;
+        } else {
+            reserve_0 = reserve0.to_double();
+            reserve_1 = reserve1.to_double();
+        }
+        reserve_in = zero_for_one ? reserve_0 : reserve_1;
+        reserve_out = zero_for_one ? reserve_1 : reserve_0;
+        return reserve_in > 0.0 && reserve_out > 0.0;
+    }
+};
+
+static_assert(sizeof(PoolState) % sizeof(uint64_t) == 0, "PoolState is copied as whole words");
+
+// Event topics and view selectors the cache is fed from
+namespace pool_events {
+constexpr char kSyncSignature[] = "Sync(uint112,uint112)";
+constexpr char kSwapV3Signature[] = "Swap(address,address,int256,int256,uint160,uint128,int24)";
+constexpr std::array<uint8_t, 32> kSyncTopic =
+    keccak::hash256(kSyncSignature, keccak::length_of(kSyncSignature));
+constexpr std::array<uint8_t, 32> kSwapV3Topic =
+    keccak::hash256(kSwapV3Signature, keccak::length_of(kSwapV3Signature));
+static_assert(kSyncTopic[0] == 0x1c && kSyncTopic[1] == 0x41 && kSyncTopic[31] == 0xd1, "Sync topic");
+static_assert(kSwapV3Topic[0] == 0xc4 && kSwapV3Topic[1] == 0x20 && kSwapV3Topic[31] == 0x67, "V3 Swap topic");
+
+constexpr uint32_t kGetReserves = keccak::selector("getReserves()");
+constexpr uint32_t kSlot0 = keccak::selector("slot0()");
+constexpr uint32_t kLiquidity = keccak::selector("liquidity()");
+static_assert(kGetReserves == 0x0902f1ac, "getReserves selector");
+static_assert(kSlot0 == 0x3850c7bd, "slot0 selector");
+static_assert(kLiquidity == 0x1a686502, "liquidity selector");
+} // namespace pool_events
+
+// Derives pool addresses from token pairs the way the factories deploy
+// them (CREATE2), so finding a pool costs two keccak hashes and no RPC.
+class PoolResolver {
+public:
+    PoolResolver() : PoolResolver(AmmConfig{}) {}
+
+    explicit PoolResolver(const AmmConfig& config) {
+        load(PoolVenue::UniswapV2, "uniswap_v2", config.uniswap_v2_factory, config.uniswap_v2_init_code_hash);
+        load(PoolVenue::SushiSwap, "sushiswap", config.sushiswap_factory, config.sushiswap_init_code_hash);
+        load(PoolVenue::UniswapV3, "uniswap_v3", config.uniswap_v3_factory, config.uniswap_v3_init_code_hash);
+    }
+
+    // Orders a pair the way pools store it (token0 < token1)
+    static void sort_tokens(const Address& a, const Address& b, Address& token0, Address& token1) {
+        bool less = std::memcmp(a.bytes, b.bytes, Address::kSize) < 0;
+        token0 = less ? a : b;
+        token1 = less ? b : a;
+    }
+
+    // False when the venue has no factory configured or the tokens are equal
+    bool resolve(PoolVenue venue, const Address& a, const Address& b, uint32_t fee, Address& pool) const {
+        const Factory& factory = factories_[static_cast<size_t>(venue)];
+        if (!factory.valid || a == b) {
+            return false;
+        }
+        Address token0;
+        Address token1;
+        sort_tokens(a, b, token0, token1);
+
+        // V2: salt = keccak(token0 ++ token1); V3: keccak(abi.encode(token0, token1, fee))
+        uint8_t salt_input[96] = {};
+        size_t salt_length = 0;
+        if (venue == PoolVenue::UniswapV3) {
+            std::memcpy(salt_input + 12, token0.bytes, Address::kSize);
+            std::memcpy(salt_input + 44, token1.bytes, Address::kSize);
+            for (size_t i = 0; i < 4; ++i) {
+                salt_input[95 - i] = static_cast<uint8_t>(fee >> (8 * i));
+            }
+            salt_length = 96;
+        } else {
+            std::memcpy(salt_input, token0.bytes, Address::kSize);
+            std::memcpy(salt_input + Address::kSize, token1.bytes, Address::kSize);
+            salt_length = 2 * Address::kSize;
+        }
+        std::array<uint8_t, 32> salt = keccak::hash256(salt_input, salt_length);
+
+        // address = keccak(0xff ++ factory ++ salt ++ init_code_hash)[12:]
+        uint8_t create2_input[85];
+        create2_input[0] = 0xff;
+        std::memcpy(create2_input + 1, factory.address.bytes, Address::kSize);
+        std::memcpy(create2_input + 21, salt.data(), salt.size());
+        std::memcpy(create2_input + 53, factory.init_code_hash.bytes, Hash32::kSize);
+        std::array<uint8_t, 32> digest = keccak::hash256(create2_input, sizeof(create2_input));
+        std::memcpy(pool.bytes, digest.data() + 12, Address::kSize);
+        return true;
+    }
+
+private:
+    struct Factory {
+        Address address;
+        Hash32 init_code_hash;
+        bool valid = false;
+    };
+
+    std::array<Factory, 3> factories_;
+
+    void load(PoolVenue venue, const char* name, const std::string& address, const std::string& init_code_hash) {
+        if (address.empty()) {
+            return;
+        }
+        Factory& factory = factories_[static_cast<size_t>(venue)];
+        factory.valid = Address::from_hex(address.data(), address.size(), factory.address) &&
+                        Hash32::from_hex(init_code_hash.data(), init_code_hash.size(), factory.init_code_hash);
+        if (!factory.valid) {
+            LOG_WARN("Ignoring {} factory: invalid address or init code hash", name);
+        }
+    }
+};
+
+// Shared, in-memory state of every pool the analysis has touched.
+//
+// Readers (the analysis workers) never lock: each slot is a seqlock, so
+// snapshot() copies the state and retries only if a writer was mid-update.
+// Writers (log notifications on the I/O thread, bootstrap results on the
+// sync thread) serialize on a mutex that readers never see. The table is
+// open-addressed with a fixed capacity and entries are never removed, so a
+// slot's key stays valid once published.
+//
+// A pool moves Empty -> Idle -> Queued -> Ready (or Missing if no contract
+// exists at the CREATE2 address). request() queues unknown pools for the
+// bootstrapper; Sync/Swap logs then keep Ready pools current.
+class PoolCache {
+public:
+    enum Status : uint8_t { kEmpty, kIdle, kQueued, kReady, kMissing };
+
+    struct Request {
+        Address pool;
+        PoolVenue venue = PoolVenue::UniswapV2;
+    };
+
+    explicit PoolCache(const AmmConfig& config = AmmConfig{})
+        : resolver_(config)
+        , max_pools_(config.max_pools > 0 ? static_cast<size_t>(config.max_pools) : 1)
+        , requests_(round_up_pow2(max_pools_)) {
+        // At most half full, so probe sequences stay short
+        size_t capacity = round_up_pow2(max_pools_ * 2);
+        slots_.reset(new Slot[capacity]);
+        mask_ = capacity - 1;
+        shift_ = 64 - static_cast<unsigned>(__builtin_ctzll(capacity));
+    }
+
+    PoolCache(const PoolCache&) = delete;
+    PoolCache& operator=(const PoolCache&) = delete;
+
+    const PoolResolver& resolver() const { return resolver_; }
+
+    // Lock-free. True only for pools with bootstrapped or logged state.
+    bool snapshot(const Address& pool, PoolState& out) const {
+        const Slot* slot = find(pool);
+        if (!slot || slot->status.load(std::memory_order_acquire) != kReady) {
+            return false;
+        }
+        load(*slot, out);
+        return true;
+    }
+
+    Status status(const Address& pool) const {
+        const Slot* slot = find(pool);
+        return slot ? static_cast<Status>(slot->status.load(std::memory_order_acquire)) : kEmpty;
+    }
+
+    // Asks the bootstrapper for a pool's state. Cheap and lock-free when the
+    // pool is already known; the first request per pool takes the writer
+    // lock. False when the cache is full or the request ring is backed up.
+    bool request(const Address& pool, PoolVenue venue, const Address& token0,
+                 const Address& token1, uint32_t fee) {
+        Status current = status(pool);
+        if (current != kEmpty && current != kIdle) {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        Slot* slot = find_or_insert(pool);
+        if (!slot) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        uint8_t state = slot->status.load(std::memory_order_relaxed);
+        if (state == kEmpty) {
+            PoolState initial;
+            initial.venue = venue;
+            initial.fee = venue == PoolVenue::UniswapV3 ? fee : 3000;
+            initial.token0 = token0;
+            initial.token1 = token1;
+            store(*slot, initial);
+            slot->status.store(kIdle, std::memory_order_release);
+            state = kIdle;
+        }
+        if (state != kIdle) {
+            return true;
+        }
+        if (!requests_.try_push(Request{pool, venue})) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slot->status.store(kQueued, std::memory_order_release);
+        return true;
+    }
+
+    // Resolves the pool for a pair and requests it; used to warm the cache
+    bool request_pair(PoolVenue venue, const Address& a, const Address& b, uint32_t fee) {
+        Address pool;
+        Address token0;
+        Address token1;
+        if (!resolver_.resolve(venue, a, b, fee, pool)) {
+            return false;
+        }
+        PoolResolver::sort_tokens(a, b, token0, token1);
+        return request(pool, venue, token0, token1, fee);
+    }
+
+    // Bootstrapper side: next pool waiting for its first read
+    bool next_request(Request& out) { return requests_.try_pop(out); }
+
+    // Bootstrap results. Skipped once the pool is Ready: a log got there
+    // first and is at least as new as the "latest" read.
+    void apply_v2_reserves(const Address& pool, const Uint256& reserve0, const Uint256& reserve1) {
+        update(pool, /*from_log=*/false, 0, 0, [&](PoolState& state) {
+            state.reserve0 = reserve0;
+            state.reserve1 = reserve1;
+        });
+    }
+
+    void apply_v3_state(const Address& pool, const Uint256& sqrt_price_x96, int32_t tick,
+                        const Uint256& liquidity) {
+        update(pool, false, 0, 0, [&](PoolState& state) {
+            state.sqrt_price_x96 = sqrt_price_x96;
+            state.tick = tick;
+            state.liquidity = liquidity;
+        });
+    }
+
+    // Sync(reserve0, reserve1) from a V2 pair
+    void apply_sync(const Address& pool, uint64_t block_number, uint32_t log_index,
+                    const Uint256& reserve0, const Uint256& reserve1) {
+        update(pool, true, block_number, log_index, [&](PoolState& state) {
+            state.reserve0 = reserve0;
+            state.reserve1 = reserve1;
+        });
+    }
+
+    // Swap(..., sqrtPriceX96, liquidity, tick) from a V3 pool
+    void apply_swap(const Address& pool, uint64_t block_number, uint32_t log_index,
+                    const Uint256& sqrt_price_x96, const Uint256& liquidity, int32_t tick) {
+        update(pool, true, block_number, log_index, [&](PoolState& state) {
+            state.sqrt_price_x96 = sqrt_price_x96;
+            state.liquidity = liquidity;
+            state.tick = tick;
+        });
+    }
+
+    // No contract at the address (pair never created); never re-requested
+    void mark_missing(const Address& pool) { set_status(pool, kQueued, kMissing); }
+
+    // Bootstrap failed; the next request() queues the pool again
+    void mark_idle(const Address& pool) { set_status(pool, kQueued, kIdle); }
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t ready_count() const { return ready_.load(std::memory_order_relaxed); }
+    uint64_t log_update_count() const { return log_updates_.load(std::memory_order_relaxed); }
+    uint64_t rejected_count() const { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kStateWords = sizeof(PoolState) / sizeof(uint64_t);
+    static constexpr size_t kKeyWords = 3;  // 20-byte address, zero padded
+
+    // The key is written once before the status leaves kEmpty, so a reader
+    // that observes a non-empty status (acquire) also sees the key
+    struct alignas(kCacheLineSize) Slot {
+        std::atomic<uint64_t> key[kKeyWords] = {};
+        std::atomic<uint8_t> status{kEmpty};
+        std::atomic<uint64_t> sequence{0};      // odd while a writer is inside
+        std::atomic<uint64_t> words[kStateWords] = {};
+    };
+
+    PoolResolver resolver_;
+    size_t max_pools_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    unsigned shift_ = 63;
+    std::mutex write_mutex_;
+    RingBuffer<Request> requests_;
+
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> ready_{0};
+    std::atomic<uint64_t> log_updates_{0};
+    std::atomic<uint64_t> rejected_{0};
+
+    static void pack_key(const Address& address, uint64_t (&key)[kKeyWords]) {
+        uint8_t padded[kKeyWords * sizeof(uint64_t)] = {};
+        std::memcpy(padded, address.bytes, Address::kSize);
+        std::memcpy(key, padded, sizeof(padded));
+    }
+
+    size_t home_slot(const uint64_t (&key)[kKeyWords]) const {
+        return static_cast<size_t>((key[1] * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    static bool key_matches(const Slot& slot, const uint64_t (&key)[kKeyWords]) {
+        return slot.key[0].load(std::memory_order_relaxed) == key[0] &&
+               slot.key[1].load(std::memory_order_relaxed) == key[1] &&
+               slot.key[2].load(std::memory_order_relaxed) == key[2];
+    }
+
+    // Linear probe; unique_ptr hands out mutable slots even from const
+    // methods, which the writers rely on after a lock-free lookup
+    Slot* find(const Address& pool) const {
+        uint64_t key[kKeyWords];
+        pack_key(pool, key);
+        for (size_t i = home_slot(key), probes = 0; probes <= mask_; i = (i + 1) & mask_, ++probes) {
+            Slot& slot = slots_[i];
+            if (slot.status.load(std::memory_order_acquire) == kEmpty) {
+                return nullptr;
+            }
+            if (key_matches(slot, key)) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    // Only under write_mutex_. A new slot gets its key here and is
+    // published by the caller moving it out of kEmpty.
+    Slot* find_or_insert(const Address& pool) {
+        uint64_t key[kKeyWords];
+        pack_key(pool, key);
+        for (size_t i = home_slot(key), probes = 0; probes <= mask_; i = (i + 1) & mask_, ++probes) {
+            Slot& slot = slots_[i];
+            if (slot.status.load(std::memory_order_relaxed) == kEmpty) {
+                if (size_.load(std::memory_order_relaxed) >= max_pools_) {
+                    return nullptr;
+                }
+                for (size_t w = 0; w < kKeyWords; ++w) {
+                    slot.key[w].store(key[w], std::memory_order_relaxed);
+                }
+                size_.fetch_add(1, std::memory_order_relaxed);
+                return &slot;
+            }
+            if (key_matches(slot, key)) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    static void load(const Slot& slot, PoolState& out) {
+        uint64_t words[kStateWords];
+        for (;;) {
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+#if defined(__SSE2__)
+                _mm_pause();
+#endif
+                continue;
+            }
+            for (size_t i = 0; i < kStateWords; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        std::memcpy(&out, words, sizeof(out));
+    }
+
+    // Single writer at a time (write_mutex_)
+    static void store(Slot& slot, const PoolState& state) {
+        uint64_t words[kStateWords];
+        std::memcpy(words, &state, sizeof(state));
+        uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kStateWords; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Logs apply in (block, log index) order, so a duplicate from a second
+    // provider or a late frame never rolls state back. Removed (reorged)
+    // logs are never passed in; the next event corrects the state.
+    template <typename Apply>
+    void update(const Address& pool, bool from_log, uint64_t block_number, uint32_t log_index,
+                Apply&& apply) {
+        Slot* slot = find(pool);
+        if (!slot) {
+            return;  // most logs are for pools nobody asked about
+        }
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        uint8_t state = slot->status.load(std::memory_order_relaxed);
+        if (state == kEmpty || state == kMissing) {
+            return;
+        }
+        PoolState current;
+        load(*slot, current);
+        if (from_log) {
+            bool newer = current.block_number == 0 || block_number > current.block_number ||
+                         (block_number == current.block_number && log_index > current.log_index);
+            if (!newer) {
+                return;
+            }
+            current.block_number = block_number;
+            current.log_index = log_index;
+            log_updates_.fetch_add(1, std::memory_order_relaxed);
+        } else if (state == kReady) {
+            return;
+        }
+        apply(current);
+        store(*slot, current);
+        if (state != kReady) {
+            slot->status.store(kReady, std::memory_order_release);
+            ready_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void set_status(const Address& pool, uint8_t from, uint8_t to) {
+        Slot* slot = find(pool);
+        if (!slot) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (slot->status.load(std::memory_order_relaxed) == from) {
+            slot->status.store(to, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace mev_shield
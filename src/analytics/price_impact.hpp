@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "analytics/pool_cache.hpp"
+#include "analytics/swap.hpp"
+
+namespace mev_shield {
+
+// One cached pool as seen from a leg's input side, in raw token units
+struct PoolHop {
+    double reserve_in = 0.0;
+    double reserve_out = 0.0;
+    double fee = 0.0;            // fraction, 0.003 = 0.3%
+    bool priced = false;         // false when the pool is not cached yet
+};
+
+struct PriceImpact {
+    double percent = 0.0;        // worst swap in the transaction
+    size_t priced_legs = 0;
+    size_t missing_legs = 0;     // pools not cached yet (now requested) or unresolvable
+};
+
+// Price impact of decoded swaps against cached pool state, in closed form:
+// a hop paying `in` (after fee) into reserves (R_in, R_out) moves the price
+// by in / (R_in + in), and a multi-hop swap compounds its hops. V3 pools use
+// their virtual reserves in the active range, which ignores tick crossings,
+// so very large V3 swaps are underestimated.
+//
+// Each RiskEngine copy owns one estimator. Its direct-mapped memo of pair ->
+// pool address keeps the two CREATE2 keccak hashes off the hot path after a
+// pair's first sighting on that worker.
+class PriceImpactEstimator {
+public:
+    explicit PriceImpactEstimator(std::shared_ptr<PoolCache> cache = nullptr) : cache_(std::move(cache)) {}
+
+    const std::shared_ptr<PoolCache>& cache() const { return cache_; }
+
+    // `v2_venue` says which V2 deployment the transaction's router trades on.
+    // If `hops` is given (SwapLegs::kMaxLegs entries) it receives each
+    // leg's pool, for callers that price more than impact.
+    PriceImpact estimate(const SwapLegs& legs, PoolVenue v2_venue, PoolHop* hops = nullptr) {
+        PriceImpact impact;
+        if (!cache_) {
+            return impact;
+        }
+        PoolHop scratch[SwapLegs::kMaxLegs];
+        for (size_t begin = 0; begin < legs.count;) {
+            size_t end = begin + 1;
+            while (end < legs.count && legs.legs[end].swap_index == legs.legs[begin].swap_index) {
+                ++end;
+            }
+            double percent = 0.0;
+            if (price_swap(legs.legs + begin, end - begin, v2_venue, hops ? hops + begin : scratch,
+                           impact, percent)) {
+                impact.percent = std::max(impact.percent, percent);
+            }
+            begin = end;
+        }
+        return impact;
+    }
+
+private:
+    static constexpr size_t kMemoSize = 256;
+
+    struct MemoEntry {
+        Address token0;
+        Address token1;
+        Address pool;
+        uint32_t fee = 0;
+        PoolVenue venue = PoolVenue::UniswapV2;
+        bool valid = false;
+    };
+
+    std::shared_ptr<PoolCache> cache_;
+    std::array<MemoEntry, kMemoSize> memo_{};
+
+    // Every hop must be priced; a swap with any unknown pool is left out
+    // rather than reported with a partial, too-low impact
+    bool price_swap(const SwapLeg* legs, size_t count, PoolVenue v2_venue, PoolHop* hops,
+                    PriceImpact& impact, double& percent) {
+        size_t found = 0;
+        for (size_t i = 0; i < count; ++i) {
+            PoolVenue venue = legs[i].protocol == SwapProtocol::UniswapV3 ? PoolVenue::UniswapV3 : v2_venue;
+            PoolState state;
+            hops[i].fee = static_cast<double>(legs[i].fee) / 1e6;
+            hops[i].priced = lookup(legs[i], venue, state) &&
+                state.reserves_for(legs[i].token_in, hops[i].reserve_in, hops[i].reserve_out);
+            found += hops[i].priced ? 1 : 0;
+        }
+        impact.missing_legs += count - found;
+        if (found != count) {
+            return false;
+        }
+
+        const SwapLeg& first = legs[0];
+        const SwapLeg& last = legs[count - 1];
+        double remaining = 1.0;          // fraction of the mid price kept
+        if (first.exact_input && !first.amount_in.is_zero()) {
+            remaining = walk_exact_input(hops, count, first.amount_in.to_double());
+        } else if (!first.exact_input && !last.amount_out.is_zero()) {
+            remaining = walk_exact_output(hops, count, last.amount_out.to_double());
+        } else {
+            return false;                // nothing to size the swap by
+        }
+        impact.priced_legs += count;
+        percent = (1.0 - remaining) * 100.0;
+        return true;
+    }
+
+    static double walk_exact_input(const PoolHop* hops, size_t count, double amount) {
+        double remaining = 1.0;
+        for (size_t i = 0; i < count; ++i) {
+            double in = amount * (1.0 - hops[i].fee);
+            remaining *= hops[i].reserve_in / (hops[i].reserve_in + in);
+            amount = in * hops[i].reserve_out / (hops[i].reserve_in + in);
+        }
+        return remaining;
+    }
+
+    // Walks back from the exact output: a hop delivering `out` moves the
+    // price by out / R_out and needs R_in * out / (R_out - out) in
+    static double walk_exact_output(const PoolHop* hops, size_t count, double amount) {
+        double remaining = 1.0;
+        for (size_t i = count; i-- > 0;) {
+            if (amount >= hops[i].reserve_out) {
+                return 0.0;              // drains the pool; the swap would revert
+            }
+            remaining *= 1.0 - amount / hops[i].reserve_out;
+            amount = hops[i].reserve_in * amount / (hops[i].reserve_out - amount) / (1.0 - hops[i].fee);
+        }
+        return remaining;
+    }
+
+    // Snapshot of the leg's pool; unknown pools are requested from the
+    // bootstrapper so the next swap through them is priced
+    bool lookup(const SwapLeg& leg, PoolVenue venue, PoolState& state) {
+        uint32_t fee = venue == PoolVenue::UniswapV3 ? leg.fee : 0;
+        Address token0;
+        Address token1;
+        PoolResolver::sort_tokens(leg.token_in, leg.token_out, token0, token1);
+
+        uint64_t a;
+        uint64_t b;
+        std::memcpy(&a, token0.bytes + 12, sizeof(a));
+        std::memcpy(&b, token1.bytes + 12, sizeof(b));
+        uint64_t mixed = (a ^ (b * 0x9E3779B97F4A7C15ULL) ^ (uint64_t{fee} << 8) ^
+                          static_cast<uint64_t>(venue)) * 0xD1B54A32D192ED03ULL;
+        MemoEntry& entry = memo_[mixed >> 56];
+
+        if (!entry.valid || entry.fee != fee || entry.venue != venue ||
+            entry.token0 != token0 || entry.token1 != token1) {
+            if (!cache_->resolver().resolve(venue, token0, token1, leg.fee, entry.pool)) {
+                entry.valid = false;
+                return false;
+            }
+            entry.token0 = token0;
+            entry.token1 = token1;
+            entry.fee = fee;
+            entry.venue = venue;
+            entry.valid = true;
+        }
+
+        if (cache_->snapshot(entry.pool, state)) {
+            return true;
+        }
+        cache_->request(entry.pool, venue, token0, token1, leg.fee);
+        return false;
+    }
+};
+
+} // namespace mev_shield
@@ -4,88 +4,239 @@
 #include <vector>
 #include <rapidjson/document.h>
 #include "common/config.hpp"
+#include "common/config_loader.hpp"
 #include "common/logger.hpp"
-#include <chrono> 
+#include "analytics/analysis_batch.hpp"
+#include "analytics/pool_cache.hpp"
+#include "analytics/price_impact.hpp"
+#include "analytics/router_table.hpp"
+#include "analytics/sandwich.hpp"
+#include "analytics/swap_decoder.hpp"
+#include "analytics/transaction.hpp"
+#include "analytics/transaction_analysis.hpp"
 #include <algorithm>
 
 namespace mev_shield {
 
-struct TransactionAnalysis {
-    enum RiskLevel { LOW, MEDIUM, HIGH };
-    
-    RiskLevel risk_level = LOW;
-    double estimated_mev_profit_eth = 0.0;
-    double slippage_percent = 0.0;
-    std::string risk_reason;
-    std::vector<std::string> risk_factors;
-    bool is_dex_swap = false;
-    int64_t analysis_time_ms = 0;
-};
-
 class RiskEngine {
 public:
     // KEEP ONLY ONE CONSTRUCTOR to avoid ambiguity
-    RiskEngine(double min_profit_threshold = 0.01, double high_risk_slippage = 3.0)
-        : min_profit_threshold_(min_profit_threshold)
+    RiskEngine(double min_profit_threshold = 0.01, double high_risk_slippage = 3.0,
+               const DEXRouters& dex_routers = DEXRouters{},
+               std::shared_ptr<PoolCache> pool_cache = nullptr)
+        : router_table_(dex_routers.entries())
+        , price_impact_(std::move(pool_cache))
+        , min_profit_threshold_(min_profit_threshold)
         , high_risk_slippage_(high_risk_slippage) {
-        initialize_dex_routers();
         initialize_tokens();
+        for (size_t id = 0; id < router_table_.size(); ++id) {
+            if (router_table_.name(static_cast<RouterTable::RouterId>(id)) == "sushiswap") {
+                sushiswap_router_ = static_cast<RouterTable::RouterId>(id);
+            }
+        }
     }
     
+    const RouterTable& routers() const { return router_table_; }
+    
+    // Null when the AMM cache is disabled; shared by every engine copy
+    const std::shared_ptr<PoolCache>& pool_cache() const { return price_impact_.cache(); }
+    
     // Add the method that your tests expect
     bool analyze_opportunity(double potential_profit_eth, double slippage_percent) {
         return potential_profit_eth >= min_profit_threshold_ && 
                slippage_percent <= high_risk_slippage_;
     }
     
+    // Accepts a full eth_getTransactionByHash response ({"result": {...}})
     TransactionAnalysis analyze_transaction(const rapidjson::Document& tx_data) {
-        auto start_time = std::chrono::steady_clock::now();
+        if (tx_data.IsObject() && tx_data.HasMember("result") && tx_data["result"].IsObject()) {
+            return analyze_transaction(tx_data["result"]);
+        }
+        
+        TransactionAnalysis analysis;
+        analysis.risk_reason = TransactionAnalysis::Reason::MissingTransaction;
+        return analysis;
+    }
+    
+    // Accepts the transaction object itself, e.g. one entry of a batch response
+    TransactionAnalysis analyze_transaction(const rapidjson::Value& tx) {
+        PendingTransaction decoded;
+        if (!decode_transaction(tx, decoded)) {
+            TransactionAnalysis analysis;
+            analysis.risk_reason = TransactionAnalysis::Reason::MalformedTransaction;
+            return analysis;
+        }
+        return analyze_transaction(decoded.tx);
+    }
+    
+    TransactionAnalysis analyze_transaction(const TransactionInfo& tx_info) {
         TransactionAnalysis analysis;
         
         try {
-            auto tx_info = extract_transaction_info(tx_data);
-            analysis.is_dex_swap = is_dex_transaction(tx_info.to);
-            
-            if (analysis.is_dex_swap) {
-                analyze_dex_risk(tx_info, analysis);
-            } else {
-                analysis.risk_level = TransactionAnalysis::LOW;
-                analysis.risk_reason = "Non-DEX transaction - low MEV risk";
-            }
-            
+            // A batch of one, so both entry points share every code path
+            single_tx_.clear();
+            single_tx_.push(tx_info, router_table_);
+            analyze_batch(single_tx_, single_result_);
+            analysis = describe(single_result_, 0);
         } catch (const std::exception& e) {
+            LOG_DEBUG("Analysis error: {}", e.what());
+            analysis = TransactionAnalysis{};
             analysis.risk_level = TransactionAnalysis::LOW;
-            analysis.risk_reason = "Analysis error: " + std::string(e.what());
+            analysis.risk_reason = TransactionAnalysis::Reason::AnalysisError;
+        }
+        return analysis;
+    }
+    
+    // Analyzes every row of `batch` into `out` column by column: the router
+    // filter, per-swap decoding and pricing, one sandwich kernel call for
+    // all victims in the batch, then branch-free classification. `out` is
+    // reused across calls and only grows when a larger batch arrives.
+    void analyze_batch(const TransactionBatch& batch, AnalysisBatch& out) {
+        size_t rows = batch.size();
+        out.reset(rows);
+        victims_.clear();
+        
+        const RouterTable::RouterId* router = batch.router();
+        for (size_t i = 0; i < rows; ++i) {
+            out.is_dex_swap[i] = router[i] != RouterTable::kNotFound;
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            if (out.is_dex_swap[i]) {
+                price_swaps(batch, i, out);
+            }
         }
         
-        auto end_time = std::chrono::steady_clock::now();
-        analysis.analysis_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            end_time - start_time).count();
-            
+        victims_.optimize();
+        for (size_t k = 0; k < victims_.size(); ++k) {
+            size_t row = victims_.row[k];
+            double profit_eth = victims_.profit_in[k] * victims_.to_eth[k];
+            if (profit_eth > out.mev_profit_eth[row]) {
+                out.mev_profit_eth[row] = profit_eth;
+                out.sandwich_frontrun_eth[row] = victims_.frontrun_in[k] * victims_.to_eth[k];
+            }
+        }
+        
+        // RiskLevel is LOW/MEDIUM/HIGH = 0/1/2, so the level is a sum of
+        // comparisons
+        static_assert(TransactionAnalysis::LOW == 0 && TransactionAnalysis::MEDIUM == 1 &&
+                      TransactionAnalysis::HIGH == 2, "risk levels are counted");
+        const double* profit = out.mev_profit_eth.data();
+        const double* slippage = out.slippage_percent.data();
+        uint8_t* level = out.risk_level.data();
+        uint8_t* high_slippage = out.high_slippage.data();
+        uint8_t* opportunity = out.opportunity.data();
+        for (size_t i = 0; i < rows; ++i) {
+            level[i] = static_cast<uint8_t>((profit[i] > kMediumRiskProfitEth) + (profit[i] > kHighRiskProfitEth));
+            high_slippage[i] = slippage[i] > kHighSlippagePercent;
+            opportunity[i] = (profit[i] >= min_profit_threshold_) & (slippage[i] <= high_risk_slippage_);
+        }
+    }
+    
+    // Copies one row of an analyzed batch out as a TransactionAnalysis;
+    // no allocation, factor text is produced only when reported
+    TransactionAnalysis describe(const AnalysisBatch& batch, size_t row) const {
+        TransactionAnalysis analysis;
+        analysis.risk_level = static_cast<TransactionAnalysis::RiskLevel>(batch.risk_level[row]);
+        analysis.is_dex_swap = batch.is_dex_swap[row] != 0;
+        if (!analysis.is_dex_swap) {
+            analysis.risk_reason = TransactionAnalysis::Reason::NonDex;
+            return analysis;
+        }
+        analysis.estimated_mev_profit_eth = batch.mev_profit_eth[row];
+        analysis.sandwich_frontrun_eth = batch.sandwich_frontrun_eth[row];
+        analysis.slippage_percent = batch.slippage_percent[row];
+        analysis.swap_legs = batch.swap_legs[row];
+        analysis.missing_legs = batch.missing_legs[row];
+        analysis.swap_notional_eth = batch.swap_notional_eth[row];
+        
+        switch (analysis.risk_level) {
+            case TransactionAnalysis::HIGH:
+                analysis.risk_reason = TransactionAnalysis::Reason::HighProfit;
+                break;
+            case TransactionAnalysis::MEDIUM:
+                analysis.risk_reason = TransactionAnalysis::Reason::MediumRisk;
+                break;
+            default:
+                analysis.risk_reason = TransactionAnalysis::Reason::LowRisk;
+                break;
+        }
+        
+        uint32_t factors = TransactionAnalysis::DEX_SWAP;
+        if (analysis.swap_legs > 0) {
+            factors |= TransactionAnalysis::DECODED_SWAP;
+        }
+        if (analysis.missing_legs > 0 && pool_cache()) {
+            factors |= TransactionAnalysis::POOL_NOT_CACHED;
+        }
+        if (analysis.sandwich_frontrun_eth > 0.0) {
+            factors |= TransactionAnalysis::SANDWICHABLE;
+        }
+        if (batch.high_slippage[row]) {
+            factors |= TransactionAnalysis::HIGH_SLIPPAGE;
+        }
+        analysis.risk_factors = factors;
         return analysis;
     }
 
 private:
-    struct TransactionInfo {
-        std::string hash;
-        std::string from;
-        std::string to;
-        std::string input_data;
-        std::string value;
-        double eth_value = 0.0;
+    static constexpr double kHighRiskProfitEth = 0.05;
+    static constexpr double kMediumRiskProfitEth = 0.01;
+    static constexpr double kHighSlippagePercent = 3.0;
+    
+    // Sandwich inputs gathered across a whole batch, in the layout the
+    // batch kernels read
+    struct VictimBatch {
+        std::vector<double> reserve_in, reserve_out, amount_in, min_amount_out, fee;
+        std::vector<double> to_eth;       // input token -> ETH, at the pool's mid price
+        std::vector<uint32_t> row;
+        std::vector<double> frontrun_in, profit_in;
+        
+        size_t size() const { return row.size(); }
+        
+        void clear() {
+            reserve_in.clear();
+            reserve_out.clear();
+            amount_in.clear();
+            min_amount_out.clear();
+            fee.clear();
+            to_eth.clear();
+            row.clear();
+        }
+        
+        void push(size_t at, const PoolHop& hop, const SwapLeg& leg, double eth_per_unit) {
+            reserve_in.push_back(hop.reserve_in);
+            reserve_out.push_back(hop.reserve_out);
+            amount_in.push_back(leg.amount_in.to_double());
+            min_amount_out.push_back(leg.amount_out.to_double());
+            fee.push_back(hop.fee);
+            to_eth.push_back(eth_per_unit);
+            row.push_back(static_cast<uint32_t>(at));
+        }
+        
+        void optimize() {
+            frontrun_in.resize(size());
+            profit_in.resize(size());
+            sandwich::optimize_batch(sandwich::Batch{reserve_in.data(), reserve_out.data(), amount_in.data(),
+                                                     min_amount_out.data(), fee.data(), size()},
+                                     frontrun_in.data(), profit_in.data());
+        }
     };
     
-    std::unordered_map<std::string, std::string> dex_routers_;
+    RouterTable router_table_;
+    SwapDecoder swap_decoder_;
+    PriceImpactEstimator price_impact_;
+    RouterTable::RouterId sushiswap_router_ = RouterTable::kNotFound;
+    Address weth_ = Address::from_hex(TokenAddresses{}.weth);
     std::unordered_map<std::string, std::string> token_addresses_;
     double min_profit_threshold_ = 0.01;
     double high_risk_slippage_ = 3.0;
     
-    void initialize_dex_routers() {
-        dex_routers_ = {
-            {"uniswap_v2", "0x7a250d5630B4cF539739dF2C5dAcb4c659F2488D"},
-            {"sushiswap", "0xd9e1cE17f2641f24aE83637ab66a2cca9C378B9F"}
-        };
-    }
+    // Scratch reused by every analysis on this engine copy
+    SwapLegs legs_;
+    PoolHop hops_[SwapLegs::kMaxLegs];
+    VictimBatch victims_;
+    TransactionBatch single_tx_{1};
+    AnalysisBatch single_result_{1};
     
     void initialize_tokens() {
         token_addresses_ = {
@@ -96,91 +247,61 @@ private:
         };
     }
     
-    TransactionInfo extract_transaction_info(const rapidjson::Document& tx_data) {
-        TransactionInfo info;
-        
-        if (tx_data.HasMember("result") && tx_data["result"].IsObject()) {
-            const auto& result = tx_data["result"];
-            
-            if (result.HasMember("hash") && result["hash"].IsString()) {
-                info.hash = result["hash"].GetString();
-            }
-            if (result.HasMember("from") && result["from"].IsString()) {
-                info.from = result["from"].GetString();
-            }
-            if (result.HasMember("to") && result["to"].IsString()) {
-                info.to = normalize_address(result["to"].GetString());
-            }
-            if (result.HasMember("input") && result["input"].IsString()) {
-                info.input_data = result["input"].GetString();
-            }
-            if (result.HasMember("value") && result["value"].IsString()) {
-                info.value = result["value"].GetString();
-                info.eth_value = hex_to_eth(info.value);
-            }
+    // Sizes the trade from its decoded calldata; msg.value is only a
+    // fallback, and is zero for every token-to-token or token-to-ETH swap
+    void price_swaps(const TransactionBatch& batch, size_t row, AnalysisBatch& out) {
+        const TransactionInfo& tx_info = batch.tx(row);
+        Uint256 notional_wei = tx_info.value;
+        if (batch.selector()[row] != 0 && swap_decoder_.decode(tx_info, legs_)) {
+            out.swap_legs[row] = static_cast<uint8_t>(legs_.count);
+            notional_wei = swap_notional_wei(legs_, tx_info);
+            // V2 legs trade on the router's own deployment
+            PoolVenue v2_venue = batch.router()[row] == sushiswap_router_
+                ? PoolVenue::SushiSwap : PoolVenue::UniswapV2;
+            PriceImpact impact = price_impact_.estimate(legs_, v2_venue, hops_);
+            out.slippage_percent[row] = impact.percent;
+            out.missing_legs[row] = static_cast<uint8_t>(impact.missing_legs);
+            collect_victims(row, legs_, hops_);
         }
-        
-        return info;
+        out.swap_notional_eth[row] = wei_to_ether(notional_wei);
     }
     
-    bool is_dex_transaction(const std::string& to_address) {
-        for (const auto& [name, address] : dex_routers_) {
-            if (to_address == normalize_address(address)) {
-                return true;
-            }
+    // WETH amount of the first swap: its input when it starts from WETH/ETH,
+    // else its (minimum or exact) output when it ends in WETH/ETH
+    Uint256 swap_notional_wei(const SwapLegs& legs, const TransactionInfo& tx_info) const {
+        const SwapLeg& first = legs.legs[0];
+        if (first.token_in == weth_ && !first.amount_in.is_zero()) {
+            return first.amount_in;
         }
-        return false;
-    }
-    
-    void analyze_dex_risk(const TransactionInfo& tx_info, TransactionAnalysis& analysis) {
-        // Basic risk analysis for open source version
-        analysis.estimated_mev_profit_eth = estimate_basic_profit(tx_info);
-        analysis.slippage_percent = estimate_slippage(tx_info);
-        
-        if (analysis.estimated_mev_profit_eth > 0.05) {
-            analysis.risk_level = TransactionAnalysis::HIGH;
-            analysis.risk_reason = "High MEV profit opportunity detected";
-        } else if (analysis.estimated_mev_profit_eth > 0.01) {
-            analysis.risk_level = TransactionAnalysis::MEDIUM;
-            analysis.risk_reason = "Medium MEV risk";
-        } else {
-            analysis.risk_level = TransactionAnalysis::LOW;
-            analysis.risk_reason = "Low MEV risk";
-        }
-        
-        analysis.risk_factors.push_back("DEX swap detected");
-        if (analysis.slippage_percent > 3.0) {
-            analysis.risk_factors.push_back("High slippage: " + 
-                std::to_string(analysis.slippage_percent) + "%");
-        }
-    }
-    
-    double estimate_basic_profit(const TransactionInfo& tx_info) {
-        // Basic profit estimation for open source
-        // Advanced arbitrage detection kept for commercial version
-        if (tx_info.eth_value > 10.0) {
-            return tx_info.eth_value * 0.02; // 2% estimated profit for large trades
+        for (const SwapLeg& leg : legs) {
+            if (leg.swap_index != first.swap_index) {
+                break;
+            }
+            if (leg.token_out == weth_ && !leg.amount_out.is_zero()) {
+                return leg.amount_out;
+            }
         }
-        return tx_info.eth_value * 0.005; // 0.5% for smaller trades
+        return tx_info.value;
     }
     
-    double estimate_slippage(const TransactionInfo& tx_info) {
-        // Basic slippage estimation
-        return std::min(tx_info.eth_value * 0.1, 10.0); // Max 10% slippage
-    }
-    
-    std::string normalize_address(const std::string& addr) {
-        std::string normalized = addr;
-        std::transform(normalized.begin(), normalized.end(), normalized.begin(), ::tolower);
-        return normalized;
-    }
-    
-    double hex_to_eth(const std::string& hex) {
-        if (hex.empty() || hex == "0x0" || hex == "0x") return 0.0;
-        try {
-            return std::stoull(hex.substr(2), nullptr, 16) / 1e18;
-        } catch (...) {
-            return 0.0;
+    // Queues the transaction's single-hop exact-input swaps for the
+    // sandwich kernel. Multi-hop and exact-output swaps are skipped: their
+    // victim bound spans several pools and has no closed form. Profit is
+    // valued in ETH when either side of the pool is WETH, at the pool's
+    // own mid price.
+    void collect_victims(size_t row, const SwapLegs& legs, const PoolHop* hops) {
+        for (size_t i = 0; i < legs.count; ++i) {
+            const SwapLeg& leg = legs.legs[i];
+            bool single_hop = (i == 0 || legs.legs[i - 1].swap_index != leg.swap_index) &&
+                              (i + 1 == legs.count || legs.legs[i + 1].swap_index != leg.swap_index);
+            if (!single_hop || !leg.exact_input || !hops[i].priced || leg.amount_in.is_zero()) {
+                continue;
+            }
+            if (leg.token_in == weth_) {
+                victims_.push(row, hops[i], leg, 1e-18);
+            } else if (leg.token_out == weth_) {
+                victims_.push(row, hops[i], leg, hops[i].reserve_out / hops[i].reserve_in * 1e-18);
+            }
         }
     }
 };
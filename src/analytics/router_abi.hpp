@@ -0,0 +1,342 @@
+#pragma once
+#include "analytics/abi.hpp"
+
+namespace mev_shield {
+
+// Router entry points the engine understands, declared once each. The
+// selector comes from the signature at compile time; the static_asserts
+// pin a few against their published values.
+
+namespace uniswap_v2 {
+
+// (uint256 amountOut[Min], address[] path, address to, uint256 deadline), payable
+struct EthInputArgs {
+    Uint256 amount_out;
+    abi::AddressList path;
+    Address to;
+    Uint256 deadline;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, amount_out, path, to, deadline); }
+};
+
+// (uint256 amountIn|amountOut, uint256 amountOutMin|amountInMax, address[] path, address to, uint256 deadline)
+struct TokenInputArgs {
+    Uint256 amount_a;
+    Uint256 amount_b;
+    abi::AddressList path;
+    Address to;
+    Uint256 deadline;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, amount_a, amount_b, path, to, deadline); }
+};
+
+// SwapRouter02's V2 entry points drop the deadline (it moves to multicall)
+struct TokenInputArgsNoDeadline {
+    Uint256 amount_a;
+    Uint256 amount_b;
+    abi::AddressList path;
+    Address to;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, amount_a, amount_b, path, to); }
+};
+
+struct SwapExactETHForTokens : EthInputArgs {
+    static constexpr char kSignature[] = "swapExactETHForTokens(uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = true;
+};
+
+struct SwapExactETHForTokensSupportingFeeOnTransferTokens : EthInputArgs {
+    static constexpr char kSignature[] =
+        "swapExactETHForTokensSupportingFeeOnTransferTokens(uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = true;
+};
+
+struct SwapETHForExactTokens : EthInputArgs {
+    static constexpr char kSignature[] = "swapETHForExactTokens(uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = false;
+};
+
+struct SwapExactTokensForTokens : TokenInputArgs {
+    static constexpr char kSignature[] =
+        "swapExactTokensForTokens(uint256,uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = true;
+};
+
+struct SwapExactTokensForTokensSupportingFeeOnTransferTokens : TokenInputArgs {
+    static constexpr char kSignature[] =
+        "swapExactTokensForTokensSupportingFeeOnTransferTokens(uint256,uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = true;
+};
+
+struct SwapTokensForExactTokens : TokenInputArgs {
+    static constexpr char kSignature[] =
+        "swapTokensForExactTokens(uint256,uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = false;
+};
+
+struct SwapExactTokensForETH : TokenInputArgs {
+    static constexpr char kSignature[] =
+        "swapExactTokensForETH(uint256,uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = true;
+};
+
+struct SwapExactTokensForETHSupportingFeeOnTransferTokens : TokenInputArgs {
+    static constexpr char kSignature[] =
+        "swapExactTokensForETHSupportingFeeOnTransferTokens(uint256,uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = true;
+};
+
+struct SwapTokensForExactETH : TokenInputArgs {
+    static constexpr char kSignature[] =
+        "swapTokensForExactETH(uint256,uint256,address[],address,uint256)";
+    static constexpr bool kExactInput = false;
+};
+
+struct Router02SwapExactTokensForTokens : TokenInputArgsNoDeadline {
+    static constexpr char kSignature[] = "swapExactTokensForTokens(uint256,uint256,address[],address)";
+    static constexpr bool kExactInput = true;
+};
+
+struct Router02SwapTokensForExactTokens : TokenInputArgsNoDeadline {
+    static constexpr char kSignature[] = "swapTokensForExactTokens(uint256,uint256,address[],address)";
+    static constexpr bool kExactInput = false;
+};
+
+static_assert(abi::kSelectorOf<SwapExactETHForTokens> == 0x7ff36ab5, "selector mismatch");
+static_assert(abi::kSelectorOf<SwapExactTokensForTokens> == 0x38ed1739, "selector mismatch");
+static_assert(abi::kSelectorOf<Router02SwapExactTokensForTokens> == 0x472b43f3, "selector mismatch");
+
+} // namespace uniswap_v2
+
+namespace uniswap_v3 {
+
+// Packed path: token (20) | fee (3) | token (20) | fee (3) | token ...
+constexpr size_t kPathAddressSize = 20;
+constexpr size_t kPathFeeSize = 3;
+constexpr size_t kPathHopSize = kPathAddressSize + kPathFeeSize;
+
+inline bool valid_path(ByteSpan path) {
+    return path.size >= kPathHopSize + kPathAddressSize &&
+           (path.size - kPathAddressSize) % kPathHopSize == 0;
+}
+
+inline size_t path_hops(ByteSpan path) { return (path.size - kPathAddressSize) / kPathHopSize; }
+
+// Token at position i (0..hops) and fee of hop i (0..hops-1)
+inline Address path_token(ByteSpan path, size_t i) {
+    Address token;
+    for (size_t b = 0; b < kPathAddressSize; ++b) {
+        token.bytes[b] = path.data[i * kPathHopSize + b];
+    }
+    return token;
+}
+
+inline uint32_t path_fee(ByteSpan path, size_t i) {
+    const uint8_t* fee = path.data + i * kPathHopSize + kPathAddressSize;
+    return (uint32_t{fee[0]} << 16) | (uint32_t{fee[1]} << 8) | uint32_t{fee[2]};
+}
+
+// SwapRouter: exact{Input,Output}Single((address,address,uint24,address,uint256,uint256,uint256,uint160))
+struct SingleArgs {
+    Address token_in;
+    Address token_out;
+    uint64_t fee = 0;
+    Address recipient;
+    Uint256 deadline;
+    Uint256 amount_a;            // amountIn | amountOut
+    Uint256 amount_b;            // amountOutMinimum | amountInMaximum
+    Uint256 sqrt_price_limit;
+
+    bool decode(ByteSpan args) {
+        return abi::decode_args(args, token_in, token_out, fee, recipient, deadline,
+                                amount_a, amount_b, sqrt_price_limit);
+    }
+};
+
+// SwapRouter02 variant without the deadline
+struct SingleArgsNoDeadline {
+    Address token_in;
+    Address token_out;
+    uint64_t fee = 0;
+    Address recipient;
+    Uint256 amount_a;
+    Uint256 amount_b;
+    Uint256 sqrt_price_limit;
+
+    bool decode(ByteSpan args) {
+        return abi::decode_args(args, token_in, token_out, fee, recipient,
+                                amount_a, amount_b, sqrt_price_limit);
+    }
+};
+
+// SwapRouter: exact{Input,Output}((bytes,address,uint256,uint256,uint256))
+struct PathParams {
+    ByteSpan path;
+    Address recipient;
+    Uint256 deadline;
+    Uint256 amount_a;
+    Uint256 amount_b;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, path, recipient, deadline, amount_a, amount_b); }
+};
+
+struct PathParamsNoDeadline {
+    ByteSpan path;
+    Address recipient;
+    Uint256 amount_a;
+    Uint256 amount_b;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, path, recipient, amount_a, amount_b); }
+};
+
+template <typename Params>
+struct PathArgs {
+    Params params;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, params); }
+};
+
+struct ExactInputSingle : SingleArgs {
+    static constexpr char kSignature[] =
+        "exactInputSingle((address,address,uint24,address,uint256,uint256,uint256,uint160))";
+    static constexpr bool kExactInput = true;
+};
+
+struct ExactOutputSingle : SingleArgs {
+    static constexpr char kSignature[] =
+        "exactOutputSingle((address,address,uint24,address,uint256,uint256,uint256,uint160))";
+    static constexpr bool kExactInput = false;
+};
+
+struct ExactInput : PathArgs<PathParams> {
+    static constexpr char kSignature[] = "exactInput((bytes,address,uint256,uint256,uint256))";
+    static constexpr bool kExactInput = true;
+};
+
+struct ExactOutput : PathArgs<PathParams> {
+    static constexpr char kSignature[] = "exactOutput((bytes,address,uint256,uint256,uint256))";
+    static constexpr bool kExactInput = false;
+};
+
+struct Router02ExactInputSingle : SingleArgsNoDeadline {
+    static constexpr char kSignature[] =
+        "exactInputSingle((address,address,uint24,address,uint256,uint256,uint160))";
+    static constexpr bool kExactInput = true;
+};
+
+struct Router02ExactOutputSingle : SingleArgsNoDeadline {
+    static constexpr char kSignature[] =
+        "exactOutputSingle((address,address,uint24,address,uint256,uint256,uint160))";
+    static constexpr bool kExactInput = false;
+};
+
+struct Router02ExactInput : PathArgs<PathParamsNoDeadline> {
+    static constexpr char kSignature[] = "exactInput((bytes,address,uint256,uint256))";
+    static constexpr bool kExactInput = true;
+};
+
+struct Router02ExactOutput : PathArgs<PathParamsNoDeadline> {
+    static constexpr char kSignature[] = "exactOutput((bytes,address,uint256,uint256))";
+    static constexpr bool kExactInput = false;
+};
+
+// Batches of calls to the same router; each element is full calldata
+struct Multicall {
+    static constexpr char kSignature[] = "multicall(bytes[])";
+    abi::BytesList calls;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, calls); }
+};
+
+struct MulticallWithDeadline {
+    static constexpr char kSignature[] = "multicall(uint256,bytes[])";
+    Uint256 deadline;
+    abi::BytesList calls;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, deadline, calls); }
+};
+
+static_assert(abi::kSelectorOf<ExactInputSingle> == 0x414bf389, "selector mismatch");
+static_assert(abi::kSelectorOf<ExactInput> == 0xc04b8d59, "selector mismatch");
+static_assert(abi::kSelectorOf<Router02ExactInputSingle> == 0x04e45aaf, "selector mismatch");
+static_assert(abi::kSelectorOf<Multicall> == 0xac9650d8, "selector mismatch");
+static_assert(abi::kSelectorOf<MulticallWithDeadline> == 0x5ae401dc, "selector mismatch");
+
+} // namespace uniswap_v3
+
+namespace universal_router {
+
+// execute(commands, inputs[, deadline]): one command byte per input
+struct ExecuteArgs {
+    ByteSpan commands;
+    abi::BytesList inputs;
+};
+
+struct Execute : ExecuteArgs {
+    static constexpr char kSignature[] = "execute(bytes,bytes[])";
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, commands, inputs); }
+};
+
+struct ExecuteWithDeadline : ExecuteArgs {
+    static constexpr char kSignature[] = "execute(bytes,bytes[],uint256)";
+    Uint256 deadline;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, commands, inputs, deadline); }
+};
+
+static_assert(abi::kSelectorOf<ExecuteWithDeadline> == 0x3593564c, "selector mismatch");
+
+// Commands.sol: low six bits pick the command, the top bit allows revert
+constexpr uint8_t kCommandTypeMask = 0x3f;
+
+enum Command : uint8_t {
+    V3_SWAP_EXACT_IN = 0x00,
+    V3_SWAP_EXACT_OUT = 0x01,
+    V2_SWAP_EXACT_IN = 0x08,
+    V2_SWAP_EXACT_OUT = 0x09,
+    WRAP_ETH = 0x0b,
+};
+
+// Amount placeholder meaning "the router's whole balance", e.g. right after WRAP_ETH
+inline Uint256 contract_balance() {
+    Uint256 flag;
+    flag.limbs[3] = uint64_t{1} << 63;
+    return flag;
+}
+
+// Command inputs are abi.encode(...) of these, without a selector
+
+// V3_SWAP_EXACT_{IN,OUT}: (address recipient, uint256, uint256, bytes path, bool payerIsUser)
+struct V3SwapInput {
+    Address recipient;
+    Uint256 amount_a;            // amountIn | amountOut
+    Uint256 amount_b;            // amountOutMin | amountInMax
+    ByteSpan path;
+    bool payer_is_user = false;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, recipient, amount_a, amount_b, path, payer_is_user); }
+};
+
+// V2_SWAP_EXACT_{IN,OUT}: (address recipient, uint256, uint256, address[] path, bool payerIsUser)
+struct V2SwapInput {
+    Address recipient;
+    Uint256 amount_a;
+    Uint256 amount_b;
+    abi::AddressList path;
+    bool payer_is_user = false;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, recipient, amount_a, amount_b, path, payer_is_user); }
+};
+
+// WRAP_ETH: (address recipient, uint256 amountMin)
+struct WrapEthInput {
+    Address recipient;
+    Uint256 amount;
+
+    bool decode(ByteSpan args) { return abi::decode_args(args, recipient, amount); }
+};
+
+} // namespace universal_router
+
+} // namespace mev_shield
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "common/eth_types.hpp"
+#include "common/logger.hpp"
+
+namespace mev_shield {
+
+// Immutable perfect-hash table over router addresses. The build step picks
+// a seed (growing the table if needed) under which every address lands in
+// its own slot, so a lookup is one multiply-shift and one 20-byte compare
+// no matter how many routers are watched.
+class RouterTable {
+public:
+    using RouterId = int;
+    static constexpr RouterId kNotFound = -1;
+
+    RouterTable() { build({}); }
+
+    explicit RouterTable(const std::vector<std::pair<std::string, std::string>>& routers) {
+        build(routers);
+    }
+
+    RouterId find(const Address& address) const {
+        const Slot& slot = slots_[index_of(address, seed_, shift_)];
+        return matches(slot, address) ? slot.id : kNotFound;
+    }
+
+    bool contains(const Address& address) const { return find(address) != kNotFound; }
+
+    // Name from config ("uniswap_v2", ...) for a router id
+    const std::string& name(RouterId id) const { return names_[static_cast<size_t>(id)]; }
+
+    size_t size() const { return names_.size(); }
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    // Padded to 32 bytes so two slots share a cache line and the address
+    // starts 16-byte aligned for the SSE compare
+    struct alignas(32) Slot {
+        uint8_t address[20];
+        int32_t id;      // kNotFound for an empty slot
+        uint8_t pad[8];
+    };
+    static_assert(sizeof(Slot) == 32, "router slot should stay 32 bytes");
+
+    std::vector<Slot> slots_;
+    std::vector<std::string> names_;
+    uint64_t seed_ = 0;
+    unsigned shift_ = 63;
+
+    // Addresses are already uniformly distributed, so the low 8 bytes mixed
+    // with the seed are a sufficient hash
+    static size_t index_of(const Address& address, uint64_t seed, unsigned shift) {
+        uint64_t word;
+        std::memcpy(&word, address.bytes + 12, sizeof(word));
+        return static_cast<size_t>(((word ^ seed) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    static bool matches(const Slot& slot, const Address& address) {
+#if defined(__SSE2__)
+        __m128i stored = _mm_load_si128(reinterpret_cast<const __m128i*>(slot.address));
+        __m128i wanted = _mm_loadu_si128(reinterpret_cast<const __m128i*>(address.bytes));
+        uint32_t stored_tail;
+        uint32_t wanted_tail;
+        std::memcpy(&stored_tail, slot.address + 16, sizeof(stored_tail));
+        std::memcpy(&wanted_tail, address.bytes + 16, sizeof(wanted_tail));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(stored, wanted)) == 0xFFFF &&
+               stored_tail == wanted_tail && slot.id != kNotFound;
+#else
+        return std::memcmp(slot.address, address.bytes, sizeof(slot.address)) == 0 &&
+               slot.id != kNotFound;
+#endif
+    }
+
+    void build(const std::vector<std::pair<std::string, std::string>>& routers) {
+        std::vector<Address> addresses;
+        for (const auto& [name, text] : routers) {
+            Address address;
+            if (!Address::from_hex(text.data(), text.size(), address)) {
+                LOG_WARN("Ignoring router '{}': invalid address '{}'", name, text);
+                continue;
+            }
+            bool duplicate = false;
+            for (const auto& existing : addresses) {
+                duplicate = duplicate || existing == address;
+            }
+            if (duplicate) {
+                LOG_WARN("Ignoring router '{}': address already listed", name);
+                continue;
+            }
+            addresses.push_back(address);
+            names_.push_back(name);
+        }
+
+        // Start at 4x load and double until a collision-free seed turns up;
+        // with a handful of routers this settles within a few tries
+        unsigned bits = 4;
+        while ((size_t{1} << bits) < addresses.size() * 4) {
+            bits++;
+        }
+        for (;; bits++) {
+            for (uint64_t attempt = 0; attempt < 64; ++attempt) {
+                uint64_t seed = attempt * 0xD1B54A32D192ED03ULL;
+                if (try_place(addresses, bits, seed)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    bool try_place(const std::vector<Address>& addresses, unsigned bits, uint64_t seed) {
+        Slot empty{};
+        empty.id = kNotFound;
+        slots_.assign(size_t{1} << bits, empty);
+        unsigned shift = 64 - bits;
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            Slot& slot = slots_[index_of(addresses[i], seed, shift)];
+            if (slot.id != kNotFound) {
+                return false;
+            }
+            std::memcpy(slot.address, addresses[i].bytes, sizeof(slot.address));
+            slot.id = static_cast<int32_t>(i);
+        }
+        seed_ = seed;
+        shift_ = shift;
+        return true;
+    }
+};
+
+} // namespace mev_shield
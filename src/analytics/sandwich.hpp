@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MEV_SHIELD_SANDWICH_SIMD 1
+#endif
+
+namespace mev_shield {
+namespace sandwich {
+
+// Optimal sandwich around an exact-input swap on a constant-product pool
+// with fee f (g = 1 - f), in closed form.
+//
+// With the pool's input reserve normalised to 1 (v = victim input / x,
+// a = front-run / x), the attacker's round-trip profit in the input token is
+//
+//   P(a) = (A1 a^2 + A0 a) / (g^2 a^2 + D1 a + 1)
+//   A0 = g^2 (1 + v)(1 + g v) - 1,  A1 = g^2 (1 + v) - 1,  D1 = 1 + g^2 (1 + g v)
+//
+// (the output reserve cancels out). P'(a) = 0 is a quadratic, so the
+// unconstrained optimum is one square root; A0 <= 0 means even the
+// smallest front-run loses to fees. The victim still receives
+// g v y1 / (x1 + g v) after the front-run, and requiring that to stay above
+// amountOutMin bounds a by the root of another quadratic. The optimum is
+// the smaller of the two.
+
+// One victim swap, all amounts in raw token units
+struct Input {
+    double reserve_in = 0.0;
+    double reserve_out = 0.0;
+    double amount_in = 0.0;
+    double min_amount_out = 0.0;   // 0 = no slippage bound
+    double fee = 0.003;
+};
+
+struct Result {
+    double frontrun_in = 0.0;      // attacker input, same token as the victim's
+    double profit_in = 0.0;        // before gas, in that token
+};
+
+// Structure-of-arrays view over `count` victims, for the batch kernels
+struct Batch {
+    const double* reserve_in;
+    const double* reserve_out;
+    const double* amount_in;
+    const double* min_amount_out;
+    const double* fee;
+    size_t count;
+};
+
+// --- scalar kernel (reference implementation and tail handling) ---
+
+inline Result optimize(const Input& in) {
+    Result result;
+    if (!(in.reserve_in > 0.0) || !(in.reserve_out > 0.0) || !(in.amount_in > 0.0)) {
+        return result;
+    }
+    double g = 1.0 - in.fee;
+    double g2 = g * g;
+    double loss = in.fee * (2.0 - in.fee);           // 1 - g^2 without cancellation
+    double v = in.amount_in / in.reserve_in;
+
+    double a0 = -loss + g2 * v * (1.0 + g) + g2 * g * v * v;
+    if (a0 <= 0.0) {
+        return result;
+    }
+    double a1 = -loss + g2 * v;
+    double d1 = 1.0 + g2 * (1.0 + g * v);
+
+    double q = a1 * d1 - a0 * g2;
+    double r = 2.0 * a1;
+    double disc = r * r - 4.0 * q * a0;
+    double best = std::numeric_limits<double>::infinity();
+    if (disc >= 0.0 && std::sqrt(disc) - r > 0.0) {
+        best = 2.0 * a0 / (std::sqrt(disc) - r);
+    }
+
+    if (in.min_amount_out > 0.0) {
+        // (1 + g a)(1 + a + g v) <= g v y / amountOutMin
+        double c = g * v * (in.reserve_out / in.min_amount_out);
+        double rb = g * (1.0 + g * v) + 1.0;
+        double sb = (1.0 + g * v) - c;
+        if (sb >= 0.0) {
+            return result;                           // slippage bound leaves no room
+        }
+        best = std::min(best, -2.0 * sb / (rb + std::sqrt(rb * rb - 4.0 * g * sb)));
+    }
+    if (!(best < std::numeric_limits<double>::infinity())) {
+        return result;
+    }
+
+    double profit = (a1 * best * best + a0 * best) / (g2 * best * best + d1 * best + 1.0);
+    if (profit > 0.0) {
+        result.frontrun_in = best * in.reserve_in;
+        result.profit_in = profit * in.reserve_in;
+    }
+    return result;
+}
+
+inline void optimize_scalar(const Batch& batch, double* frontrun_in, double* profit_in) {
+    for (size_t i = 0; i < batch.count; ++i) {
+        Result result = optimize(Input{batch.reserve_in[i], batch.reserve_out[i], batch.amount_in[i],
+                                       batch.min_amount_out[i], batch.fee[i]});
+        frontrun_in[i] = result.frontrun_in;
+        profit_in[i] = result.profit_in;
+    }
+}
+
+#ifdef MEV_SHIELD_SANDWICH_SIMD
+
+// Four victims per iteration; every branch of optimize() becomes a lane
+// mask, so lanes that bail out early just end up zeroed
+__attribute__((target("avx2")))
+inline void optimize_avx2(const Batch& batch, double* frontrun_in, double* profit_in) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    size_t i = 0;
+    for (; i + 4 <= batch.count; i += 4) {
+        __m256d x = _mm256_loadu_pd(batch.reserve_in + i);
+        __m256d y = _mm256_loadu_pd(batch.reserve_out + i);
+        __m256d amount = _mm256_loadu_pd(batch.amount_in + i);
+        __m256d min_out = _mm256_loadu_pd(batch.min_amount_out + i);
+        __m256d fee = _mm256_loadu_pd(batch.fee + i);
+
+        __m256d valid = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_GT_OQ),
+                                                    _mm256_cmp_pd(y, zero, _CMP_GT_OQ)),
+                                      _mm256_cmp_pd(amount, zero, _CMP_GT_OQ));
+        __m256d g = _mm256_sub_pd(one, fee);
+        __m256d g2 = _mm256_mul_pd(g, g);
+        __m256d loss = _mm256_mul_pd(fee, _mm256_sub_pd(two, fee));
+        __m256d v = _mm256_div_pd(amount, x);
+
+        __m256d a0 = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(zero, loss),
+                                                 _mm256_mul_pd(_mm256_mul_pd(g2, v), _mm256_add_pd(one, g))),
+                                   _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(g2, g), v), v));
+        valid = _mm256_and_pd(valid, _mm256_cmp_pd(a0, zero, _CMP_GT_OQ));
+        __m256d a1 = _mm256_add_pd(_mm256_sub_pd(zero, loss), _mm256_mul_pd(g2, v));
+        __m256d gv1 = _mm256_add_pd(one, _mm256_mul_pd(g, v));
+        __m256d d1 = _mm256_add_pd(one, _mm256_mul_pd(g2, gv1));
+
+        __m256d q = _mm256_sub_pd(_mm256_mul_pd(a1, d1), _mm256_mul_pd(a0, g2));
+        __m256d r = _mm256_mul_pd(two, a1);
+        __m256d disc = _mm256_sub_pd(_mm256_mul_pd(r, r), _mm256_mul_pd(_mm256_mul_pd(four, q), a0));
+        __m256d den = _mm256_sub_pd(_mm256_sqrt_pd(_mm256_max_pd(disc, zero)), r);
+        __m256d has_root = _mm256_and_pd(_mm256_cmp_pd(disc, zero, _CMP_GE_OQ),
+                                         _mm256_cmp_pd(den, zero, _CMP_GT_OQ));
+        __m256d best = _mm256_blendv_pd(inf, _mm256_div_pd(_mm256_mul_pd(two, a0), den), has_root);
+
+        // Slippage bound, only for lanes with amountOutMin > 0
+        __m256d bounded = _mm256_cmp_pd(min_out, zero, _CMP_GT_OQ);
+        __m256d c = _mm256_mul_pd(_mm256_mul_pd(g, v), _mm256_div_pd(y, min_out));
+        __m256d rb = _mm256_add_pd(_mm256_mul_pd(g, gv1), one);
+        __m256d sb = _mm256_sub_pd(gv1, c);
+        __m256d cap = _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(-2.0), sb),
+                                    _mm256_add_pd(rb, _mm256_sqrt_pd(_mm256_max_pd(
+                                        _mm256_sub_pd(_mm256_mul_pd(rb, rb),
+                                                      _mm256_mul_pd(_mm256_mul_pd(four, g), sb)), zero))));
+        valid = _mm256_andnot_pd(_mm256_and_pd(bounded, _mm256_cmp_pd(sb, zero, _CMP_GE_OQ)), valid);
+        best = _mm256_blendv_pd(best, _mm256_min_pd(best, cap), bounded);
+        valid = _mm256_and_pd(valid, _mm256_cmp_pd(best, inf, _CMP_LT_OQ));
+
+        __m256d best2 = _mm256_mul_pd(best, best);
+        __m256d profit = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(a1, best2), _mm256_mul_pd(a0, best)),
+                                       _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(g2, best2),
+                                                                   _mm256_mul_pd(d1, best)), one));
+        valid = _mm256_and_pd(valid, _mm256_cmp_pd(profit, zero, _CMP_GT_OQ));
+
+        _mm256_storeu_pd(frontrun_in + i, _mm256_and_pd(valid, _mm256_mul_pd(best, x)));
+        _mm256_storeu_pd(profit_in + i, _mm256_and_pd(valid, _mm256_mul_pd(profit, x)));
+    }
+    Batch tail{batch.reserve_in + i, batch.reserve_out + i, batch.amount_in + i,
+               batch.min_amount_out + i, batch.fee + i, batch.count - i};
+    optimize_scalar(tail, frontrun_in + i, profit_in + i);
+}
+
+#endif  // MEV_SHIELD_SANDWICH_SIMD
+
+// --- runtime dispatch ---
+
+struct Kernel {
+    const char* name;
+    void (*optimize)(const Batch& batch, double* frontrun_in, double* profit_in);
+};
+
+// Chosen once from CPUID on first use
+inline const Kernel& kernel() {
+    static const Kernel selected = [] {
+#ifdef MEV_SHIELD_SANDWICH_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Kernel{"avx2", &optimize_avx2};
+        }
+#endif
+        return Kernel{"scalar", &optimize_scalar};
+    }();
+    return selected;
+}
+
+// Evaluates every victim in `batch`; outputs hold `batch.count` entries
+inline void optimize_batch(const Batch& batch, double* frontrun_in, double* profit_in) {
+    kernel().optimize(batch, frontrun_in, profit_in);
+}
+
+} // namespace sandwich
+} // namespace mev_shield
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "common/eth_types.hpp"
+#include "common/uint256.hpp"
+
+namespace mev_shield {
+
+enum class SwapProtocol : uint8_t { UniswapV2, UniswapV3 };
+
+// One pool hop of a decoded swap. A multi-hop swap is several consecutive
+// legs sharing `swap_index`; the user's amounts sit on its end legs.
+struct SwapLeg {
+    SwapProtocol protocol = SwapProtocol::UniswapV2;
+    uint32_t fee = 3000;         // pool fee in hundredths of a bip (3000 = 0.3%)
+    Address token_in;
+    Address token_out;
+    bool exact_input = true;
+    uint8_t swap_index = 0;
+    Uint256 amount_in;           // first leg: exact input, or max input for exact-output swaps
+    Uint256 amount_out;          // last leg: minimum output, or exact output
+};
+
+// Fixed-capacity flat list of legs, filled per transaction without allocating
+struct SwapLegs {
+    static constexpr size_t kMaxLegs = 16;
+
+    SwapLeg legs[kMaxLegs];
+    size_t count = 0;
+    uint8_t swaps = 0;           // number of distinct swap_index values
+    bool truncated = false;      // more legs than kMaxLegs were present
+
+    void clear() {
+        count = 0;
+        swaps = 0;
+        truncated = false;
+    }
+
+    bool empty() const { return count == 0; }
+    const SwapLeg* begin() const { return legs; }
+    const SwapLeg* end() const { return legs + count; }
+
+    // Returns nullptr (and marks the list truncated) when full
+    SwapLeg* push() {
+        if (count == kMaxLegs) {
+            truncated = true;
+            return nullptr;
+        }
+        legs[count] = SwapLeg{};
+        return &legs[count++];
+    }
+};
+
+} // namespace mev_shield
@@ -0,0 +1,240 @@
+#pragma once
+#include <type_traits>
+#include "analytics/router_abi.hpp"
+#include "analytics/swap.hpp"
+#include "analytics/transaction.hpp"
+
+namespace mev_shield {
+
+// Turns router calldata into a flat list of swap legs: Uniswap V2 routers,
+// V3 SwapRouter / SwapRouter02 (including multicall batches and packed
+// multi-hop paths) and Universal Router command streams. Everything is
+// decoded in place from the transaction's calldata into the caller's
+// fixed-capacity SwapLegs, so the hot path never allocates. Stateless, so
+// one instance can be shared by all workers.
+class SwapDecoder {
+public:
+    // False when the calldata is not a recognised swap or is malformed
+    bool decode(const TransactionInfo& tx, SwapLegs& legs) const {
+        legs.clear();
+        Visitor visitor{tx, legs, false};
+        return visitor.dispatch(tx.calldata) && !legs.empty();
+    }
+
+private:
+    struct Visitor {
+        const TransactionInfo& tx;
+        SwapLegs& legs;
+        bool nested;             // inside a multicall; batches do not nest
+
+        bool dispatch(ByteSpan calldata) {
+            return abi::dispatch<
+                uniswap_v2::SwapExactETHForTokens,
+                uniswap_v2::SwapExactETHForTokensSupportingFeeOnTransferTokens,
+                uniswap_v2::SwapETHForExactTokens,
+                uniswap_v2::SwapExactTokensForTokens,
+                uniswap_v2::SwapExactTokensForTokensSupportingFeeOnTransferTokens,
+                uniswap_v2::SwapTokensForExactTokens,
+                uniswap_v2::SwapExactTokensForETH,
+                uniswap_v2::SwapExactTokensForETHSupportingFeeOnTransferTokens,
+                uniswap_v2::SwapTokensForExactETH,
+                uniswap_v2::Router02SwapExactTokensForTokens,
+                uniswap_v2::Router02SwapTokensForExactTokens,
+                uniswap_v3::ExactInputSingle,
+                uniswap_v3::ExactOutputSingle,
+                uniswap_v3::ExactInput,
+                uniswap_v3::ExactOutput,
+                uniswap_v3::Router02ExactInputSingle,
+                uniswap_v3::Router02ExactOutputSingle,
+                uniswap_v3::Router02ExactInput,
+                uniswap_v3::Router02ExactOutput,
+                uniswap_v3::Multicall,
+                uniswap_v3::MulticallWithDeadline,
+                universal_router::Execute,
+                universal_router::ExecuteWithDeadline>(calldata, *this);
+        }
+
+        template <typename Call>
+        bool operator()(const Call& call) {
+            if constexpr (std::is_base_of<uniswap_v2::EthInputArgs, Call>::value) {
+                // msg.value is the exact input, or the cap for exact-output swaps
+                return append_v2_path(call.path, Call::kExactInput, tx.value, call.amount_out);
+            } else if constexpr (std::is_base_of<uniswap_v2::TokenInputArgs, Call>::value ||
+                                 std::is_base_of<uniswap_v2::TokenInputArgsNoDeadline, Call>::value) {
+                return append_v2_amounts(call.path, Call::kExactInput, call.amount_a, call.amount_b);
+            } else if constexpr (std::is_base_of<uniswap_v3::SingleArgs, Call>::value ||
+                                 std::is_base_of<uniswap_v3::SingleArgsNoDeadline, Call>::value) {
+                return append_v3_single(call, Call::kExactInput);
+            } else if constexpr (std::is_same<Call, uniswap_v3::Multicall>::value ||
+                                 std::is_same<Call, uniswap_v3::MulticallWithDeadline>::value) {
+                return append_multicall(call.calls);
+            } else if constexpr (std::is_base_of<universal_router::ExecuteArgs, Call>::value) {
+                return append_commands(call.commands, call.inputs);
+            } else {
+                // exactInput / exactOutput with a packed path
+                return append_v3_amounts(call.params.path, Call::kExactInput,
+                                         call.params.amount_a, call.params.amount_b);
+            }
+        }
+
+        // Exact-input calls carry (amountIn, amountOutMin); exact-output
+        // calls carry (amountOut, amountInMax)
+        bool append_v2_amounts(const abi::AddressList& path, bool exact_input,
+                               const Uint256& amount_a, const Uint256& amount_b) {
+            return exact_input ? append_v2_path(path, true, amount_a, amount_b)
+                               : append_v2_path(path, false, amount_b, amount_a);
+        }
+
+        bool append_v3_amounts(ByteSpan path, bool exact_input,
+                               const Uint256& amount_a, const Uint256& amount_b) {
+            return exact_input ? append_v3_path(path, true, amount_a, amount_b)
+                               : append_v3_path(path, false, amount_b, amount_a);
+        }
+
+        // A V2 path [A, B, C] is the legs A->B and B->C through 0.3% pairs
+        bool append_v2_path(const abi::AddressList& path, bool exact_input,
+                            const Uint256& amount_in, const Uint256& amount_out) {
+            if (path.size < 2) {
+                return false;
+            }
+            uint8_t swap_index = legs.swaps++;
+            SwapLeg* first = nullptr;
+            SwapLeg* last = nullptr;
+            for (size_t i = 0; i + 1 < path.size; ++i) {
+                SwapLeg* leg = push_leg(SwapProtocol::UniswapV2, 3000, path[i], path[i + 1],
+                                        exact_input, swap_index);
+                if (!leg) {
+                    break;
+                }
+                first = first ? first : leg;
+                last = leg;
+            }
+            return finish_swap(first, last, amount_in, amount_out);
+        }
+
+        // Exact-input paths run tokenIn..tokenOut; exact-output paths are
+        // encoded in reverse (tokenOut first), so they are walked backwards
+        // to emit legs in execution order
+        bool append_v3_path(ByteSpan path, bool exact_input,
+                            const Uint256& amount_in, const Uint256& amount_out) {
+            if (!uniswap_v3::valid_path(path)) {
+                return false;
+            }
+            size_t hops = uniswap_v3::path_hops(path);
+            uint8_t swap_index = legs.swaps++;
+            SwapLeg* first = nullptr;
+            SwapLeg* last = nullptr;
+            for (size_t h = 0; h < hops; ++h) {
+                size_t hop = exact_input ? h : hops - 1 - h;
+                Address from = uniswap_v3::path_token(path, exact_input ? hop : hop + 1);
+                Address to = uniswap_v3::path_token(path, exact_input ? hop + 1 : hop);
+                SwapLeg* leg = push_leg(SwapProtocol::UniswapV3, uniswap_v3::path_fee(path, hop),
+                                        from, to, exact_input, swap_index);
+                if (!leg) {
+                    break;
+                }
+                first = first ? first : leg;
+                last = leg;
+            }
+            return finish_swap(first, last, amount_in, amount_out);
+        }
+
+        template <typename Single>
+        bool append_v3_single(const Single& call, bool exact_input) {
+            uint8_t swap_index = legs.swaps++;
+            SwapLeg* leg = push_leg(SwapProtocol::UniswapV3, static_cast<uint32_t>(call.fee),
+                                    call.token_in, call.token_out, exact_input, swap_index);
+            return exact_input ? finish_swap(leg, leg, call.amount_a, call.amount_b)
+                               : finish_swap(leg, leg, call.amount_b, call.amount_a);
+        }
+
+        // Every element is full calldata for the same router
+        bool append_multicall(const abi::BytesList& calls) {
+            if (nested) {
+                return false;
+            }
+            nested = true;
+            bool any = false;
+            for (size_t i = 0; i < calls.size; ++i) {
+                ByteSpan call;
+                if (calls.at(i, call)) {
+                    any = dispatch(call) || any;
+                }
+            }
+            nested = false;
+            return any;
+        }
+
+        bool append_commands(ByteSpan commands, const abi::BytesList& inputs) {
+            using namespace universal_router;
+            if (commands.size != inputs.size) {
+                return false;
+            }
+            Uint256 wrapped;     // ETH wrapped earlier in the same execute()
+            bool any = false;
+            for (size_t i = 0; i < commands.size; ++i) {
+                ByteSpan input;
+                if (!inputs.at(i, input)) {
+                    return false;
+                }
+                uint8_t command = commands[i] & kCommandTypeMask;
+                if (command == WRAP_ETH) {
+                    WrapEthInput wrap;
+                    if (wrap.decode(input)) {
+                        wrapped = wrap.amount == contract_balance() ? tx.value : wrap.amount;
+                    }
+                } else if (command == V3_SWAP_EXACT_IN || command == V3_SWAP_EXACT_OUT) {
+                    V3SwapInput swap;
+                    bool exact_input = command == V3_SWAP_EXACT_IN;
+                    if (swap.decode(input)) {
+                        resolve_balance(exact_input ? swap.amount_a : swap.amount_b, wrapped);
+                        any = append_v3_amounts(swap.path, exact_input, swap.amount_a, swap.amount_b) || any;
+                    }
+                } else if (command == V2_SWAP_EXACT_IN || command == V2_SWAP_EXACT_OUT) {
+                    V2SwapInput swap;
+                    bool exact_input = command == V2_SWAP_EXACT_IN;
+                    if (swap.decode(input)) {
+                        resolve_balance(exact_input ? swap.amount_a : swap.amount_b, wrapped);
+                        any = append_v2_amounts(swap.path, exact_input, swap.amount_a, swap.amount_b) || any;
+                    }
+                }
+                // Permit2, sweeps, transfers, NFT commands carry no swap
+            }
+            return any;
+        }
+
+        // CONTRACT_BALANCE inputs spend whatever the router holds; the only
+        // balance we can see is ETH wrapped in the same call
+        static void resolve_balance(Uint256& amount, const Uint256& wrapped) {
+            if (amount == universal_router::contract_balance()) {
+                amount = wrapped;
+            }
+        }
+
+        SwapLeg* push_leg(SwapProtocol protocol, uint32_t fee, const Address& token_in,
+                          const Address& token_out, bool exact_input, uint8_t swap_index) {
+            SwapLeg* leg = legs.push();
+            if (leg) {
+                leg->protocol = protocol;
+                leg->fee = fee;
+                leg->token_in = token_in;
+                leg->token_out = token_out;
+                leg->exact_input = exact_input;
+                leg->swap_index = swap_index;
+            }
+            return leg;
+        }
+
+        static bool finish_swap(SwapLeg* first, SwapLeg* last,
+                                const Uint256& amount_in, const Uint256& amount_out) {
+            if (!first) {
+                return false;
+            }
+            first->amount_in = amount_in;
+            last->amount_out = amount_out;
+            return true;
+        }
+    };
+};
+
+} // namespace mev_shield
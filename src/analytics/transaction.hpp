@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <rapidjson/document.h>
+#include "common/eth_types.hpp"
+#include "common/hex.hpp"
+#include "common/uint256.hpp"
+
+namespace mev_shield {
+
+// Fixed-layout record of a pending transaction, decoded once at ingest and
+// read by every engine stage. Hex text is converted to binary exactly once,
+// so comparisons are memcmp and no stage allocates or lowercases strings.
+struct TransactionInfo {
+    Hash32 hash;
+    Address from;
+    Address to;
+    bool has_to = false;        // false for contract creation
+    Uint256 value;              // wei
+    double eth_value = 0.0;
+    ByteSpan calldata;          // points into the owning PendingTransaction
+};
+
+static_assert(std::is_trivially_copyable<TransactionInfo>::value,
+              "TransactionInfo must stay a plain record");
+
+// A TransactionInfo together with the buffer its calldata span points into.
+// Move-only: moving keeps the buffer address, so the span stays valid and
+// ring slots can swap records without copying calldata.
+struct PendingTransaction {
+    TransactionInfo tx;
+    std::vector<uint8_t> calldata_buffer;
+    uint64_t enqueued_ns = 0;   // StageLatency::now_ns() at ring push
+
+    PendingTransaction() = default;
+    PendingTransaction(PendingTransaction&&) = default;
+    PendingTransaction& operator=(PendingTransaction&&) = default;
+    PendingTransaction(const PendingTransaction&) = delete;
+    PendingTransaction& operator=(const PendingTransaction&) = delete;
+
+    // Keeps the calldata buffer's capacity for the next transaction
+    void reset() {
+        tx = TransactionInfo{};
+        calldata_buffer.clear();
+    }
+
+    bool set_hash(const char* text, size_t length) {
+        return Hash32::from_hex(text, length, tx.hash);
+    }
+
+    bool set_from(const char* text, size_t length) {
+        return Address::from_hex(text, length, tx.from);
+    }
+
+    bool set_to(const char* text, size_t length) {
+        tx.has_to = Address::from_hex(text, length, tx.to);
+        return tx.has_to;
+    }
+
+    bool set_value(const char* text, size_t length) {
+        bool ok = Uint256::from_hex(text, length, tx.value);
+        tx.eth_value = ok ? wei_to_ether(tx.value) : 0.0;
+        return ok;
+    }
+
+    bool set_calldata(const char* text, size_t length) {
+        if (!hex::has_prefix(text, length) || (length & 1) != 0) {
+            return false;
+        }
+        size_t bytes = (length - 2) / 2;
+        calldata_buffer.resize(bytes);
+        if (!hex::decode(text + 2, bytes, calldata_buffer.data())) {
+            calldata_buffer.clear();
+            return false;
+        }
+        tx.calldata = ByteSpan{calldata_buffer.data(), bytes};
+        return true;
+    }
+};
+
+// Decodes an eth_getTransactionByHash / full-subscription transaction object.
+// Only the hash is mandatory; malformed optional fields are left zeroed.
+inline bool decode_transaction(const rapidjson::Value& json, PendingTransaction& out) {
+    out.reset();
+    if (!json.IsObject()) {
+        return false;
+    }
+
+    auto field = [&json](const char* name) -> const rapidjson::Value* {
+        auto it = json.FindMember(name);
+        return it != json.MemberEnd() && it->value.IsString() ? &it->value : nullptr;
+    };
+
+    const rapidjson::Value* hash = field("hash");
+    if (!hash || !out.set_hash(hash->GetString(), hash->GetStringLength())) {
+        return false;
+    }
+    if (const rapidjson::Value* from = field("from")) {
+        out.set_from(from->GetString(), from->GetStringLength());
+    }
+    if (const rapidjson::Value* to = field("to")) {
+        out.set_to(to->GetString(), to->GetStringLength());
+    }
+    if (const rapidjson::Value* value = field("value")) {
+        out.set_value(value->GetString(), value->GetStringLength());
+    }
+    if (const rapidjson::Value* input = field("input")) {
+        out.set_calldata(input->GetString(), input->GetStringLength());
+    }
+    return true;
+}
+
+} // namespace mev_shield
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mev_shield {
+
+// Result of analyzing one transaction. A plain record: the reason is an
+// enum and the factors a bitmask whose numbers sit in fixed fields, so it
+// can be copied through rings and queues as bytes. Text is produced only
+// when a result is logged or served, by the helpers below.
+struct TransactionAnalysis {
+    enum RiskLevel : uint8_t { LOW, MEDIUM, HIGH };
+
+    enum class Reason : uint8_t {
+        None,
+        NonDex,
+        LowRisk,
+        MediumRisk,
+        HighProfit,
+        MissingTransaction,
+        MalformedTransaction,
+        AnalysisError
+    };
+
+    // Bits of `risk_factors`; the comment names the field each one reports
+    enum Factor : uint32_t {
+        DEX_SWAP        = 1u << 0,
+        DECODED_SWAP    = 1u << 1,   // swap_legs
+        POOL_NOT_CACHED = 1u << 2,   // missing_legs
+        SANDWICHABLE    = 1u << 3,   // sandwich_frontrun_eth
+        HIGH_SLIPPAGE   = 1u << 4,   // slippage_percent
+    };
+
+    RiskLevel risk_level = LOW;
+    Reason risk_reason = Reason::None;
+    uint32_t risk_factors = 0;
+    bool is_dex_swap = false;
+    uint8_t swap_legs = 0;             // pool hops decoded from calldata
+    uint8_t missing_legs = 0;          // hops whose pool is not cached yet
+    double estimated_mev_profit_eth = 0.0;  // optimal sandwich, before gas
+    double sandwich_frontrun_eth = 0.0;     // front-run size that extracts it
+    double slippage_percent = 0.0;     // price impact against cached pool state
+    double swap_notional_eth = 0.0;    // ETH side of the swap, when known
+
+    bool has(Factor factor) const { return (risk_factors & factor) != 0; }
+};
+
+static_assert(std::is_trivially_copyable<TransactionAnalysis>::value,
+              "TransactionAnalysis must stay a plain record");
+
+inline const char* risk_level_name(TransactionAnalysis::RiskLevel level) {
+    switch (level) {
+        case TransactionAnalysis::MEDIUM: return "MEDIUM";
+        case TransactionAnalysis::HIGH: return "HIGH";
+        default: return "LOW";
+    }
+}
+
+inline const char* risk_reason_text(TransactionAnalysis::Reason reason) {
+    using Reason = TransactionAnalysis::Reason;
+    switch (reason) {
+        case Reason::NonDex: return "Non-DEX transaction - low MEV risk";
+        case Reason::LowRisk: return "Low MEV risk";
+        case Reason::MediumRisk: return "Medium MEV risk";
+        case Reason::HighProfit: return "High MEV profit opportunity detected";
+        case Reason::MissingTransaction: return "Analysis error: missing transaction object";
+        case Reason::MalformedTransaction: return "Analysis error: malformed transaction object";
+        case Reason::AnalysisError: return "Analysis error";
+        default: return "";
+    }
+}
+
+// One line of text per set factor, for the API and logs
+inline std::vector<std::string> risk_factor_texts(const TransactionAnalysis& analysis) {
+    std::vector<std::string> texts;
+    if (analysis.has(TransactionAnalysis::DEX_SWAP)) {
+        texts.push_back("DEX swap detected");
+    }
+    if (analysis.has(TransactionAnalysis::DECODED_SWAP)) {
+        texts.push_back("Decoded swap: " + std::to_string(analysis.swap_legs) + " hop(s)");
+    }
+    if (analysis.has(TransactionAnalysis::POOL_NOT_CACHED)) {
+        texts.push_back("Pool state not cached for " + std::to_string(analysis.missing_legs) + " hop(s)");
+    }
+    if (analysis.has(TransactionAnalysis::SANDWICHABLE)) {
+        texts.push_back("Sandwichable: " + std::to_string(analysis.sandwich_frontrun_eth) + " ETH front-run");
+    }
+    if (analysis.has(TransactionAnalysis::HIGH_SLIPPAGE)) {
+        texts.push_back("High slippage: " + std::to_string(analysis.slippage_percent) + "%");
+    }
+    return texts;
+}
+
+} // namespace mev_shield
@@ -85,26 +85,138 @@ AppConfig AppConfig::load_from_file(const std::string& config_path) {
             }
         }
         
+        // Mempool pipeline configuration
+        if (yaml_config["mempool"]) {
+            auto mempool_node = yaml_config["mempool"];
+            if (mempool_node["full_transactions"]) {
+                config.mempool.full_transactions = mempool_node["full_transactions"].as<bool>();
+            }
+            if (mempool_node["rpc_batch_size"]) {
+                config.mempool.rpc_batch_size = mempool_node["rpc_batch_size"].as<int>();
+            }
+            if (mempool_node["rpc_batch_flush_ms"]) {
+                config.mempool.rpc_batch_flush_ms = mempool_node["rpc_batch_flush_ms"].as<int>();
+            }
+            if (mempool_node["rpc_fetch_threads"]) {
+                config.mempool.rpc_fetch_threads = mempool_node["rpc_fetch_threads"].as<int>();
+            }
+            if (mempool_node["max_pending_hashes"]) {
+                config.mempool.max_pending_hashes = mempool_node["max_pending_hashes"].as<int>();
+            }
+            if (mempool_node["analysis_threads"]) {
+                config.mempool.analysis_threads = mempool_node["analysis_threads"].as<int>();
+            }
+            if (mempool_node["pin_analysis_threads"]) {
+                config.mempool.pin_analysis_threads = mempool_node["pin_analysis_threads"].as<bool>();
+            }
+            if (mempool_node["queue_capacity"]) {
+                config.mempool.queue_capacity = mempool_node["queue_capacity"].as<int>();
+            }
+            if (mempool_node["reconnect_initial_ms"]) {
+                config.mempool.reconnect_initial_ms = mempool_node["reconnect_initial_ms"].as<int>();
+            }
+            if (mempool_node["reconnect_max_ms"]) {
+                config.mempool.reconnect_max_ms = mempool_node["reconnect_max_ms"].as<int>();
+            }
+        }
+        
         // API Configuration
         if (yaml_config["api"]) {
-            config.api.port = yaml_config["api"]["port"].as<int>();
-            config.api.max_connections = yaml_config["api"]["max_connections"].as<int>();
+            auto api_node = yaml_config["api"];
+            if (api_node["port"]) {
+                config.api.port = api_node["port"].as<int>();
+            }
+            if (api_node["max_connections"]) {
+                config.api.max_connections = api_node["max_connections"].as<int>();
+            }
+            if (api_node["threads"]) {
+                config.api.threads = api_node["threads"].as<int>();
+            }
+            if (api_node["push_min_risk"]) {
+                config.api.push_min_risk = api_node["push_min_risk"].as<std::string>();
+            }
+            if (api_node["push_queue_messages"]) {
+                config.api.push_queue_messages = api_node["push_queue_messages"].as<int>();
+            }
+            if (api_node["push_overflow"]) {
+                config.api.push_overflow = api_node["push_overflow"].as<std::string>();
+            }
+            if (api_node["opportunity_capacity"]) {
+                config.api.opportunity_capacity = api_node["opportunity_capacity"].as<int>();
+            }
+            if (api_node["opportunity_ttl_seconds"]) {
+                config.api.opportunity_ttl_seconds = api_node["opportunity_ttl_seconds"].as<int>();
+            }
         }
         
-        // DEX Configuration
+        // DEX Configuration: known names override the defaults, anything
+        // else (universal_router, 1inch, ...) is watched too
         if (yaml_config["dex"] && yaml_config["dex"]["routers"]) {
-            auto routers_node = yaml_config["dex"]["routers"];
-            config.dex_routers.uniswap_v2 = routers_node["uniswap_v2"].as<std::string>();
-            config.dex_routers.uniswap_v3 = routers_node["uniswap_v3"].as<std::string>();
-            config.dex_routers.sushiswap = routers_node["sushiswap"].as<std::string>();
+            for (const auto& entry : yaml_config["dex"]["routers"]) {
+                std::string name = entry.first.as<std::string>();
+                std::string address = entry.second.as<std::string>();
+                if (name == "uniswap_v2") {
+                    config.dex_routers.uniswap_v2 = address;
+                } else if (name == "uniswap_v3") {
+                    config.dex_routers.uniswap_v3 = address;
+                } else if (name == "sushiswap") {
+                    config.dex_routers.sushiswap = address;
+                } else {
+                    config.dex_routers.additional.emplace_back(name, address);
+                }
+            }
         }
         
         // Tokens Configuration
         if (yaml_config["tokens"]) {
-            config.tokens.weth = yaml_config["tokens"]["weth"].as<std::string>();
-            config.tokens.dai = yaml_config["tokens"]["dai"].as<std::string>();
-            config.tokens.usdc = yaml_config["tokens"]["usdc"].as<std::string>();
-            config.tokens.usdt = yaml_config["tokens"]["usdt"].as<std::string>();
+            auto tokens_node = yaml_config["tokens"];
+            if (tokens_node["weth"]) {
+                config.tokens.weth = tokens_node["weth"].as<std::string>();
+            }
+            if (tokens_node["dai"]) {
+                config.tokens.dai = tokens_node["dai"].as<std::string>();
+            }
+            if (tokens_node["usdc"]) {
+                config.tokens.usdc = tokens_node["usdc"].as<std::string>();
+            }
+            if (tokens_node["usdt"]) {
+                config.tokens.usdt = tokens_node["usdt"].as<std::string>();
+            }
+        }
+        
+        // AMM pool cache
+        if (yaml_config["amm"]) {
+            auto amm_node = yaml_config["amm"];
+            if (amm_node["enabled"]) {
+                config.amm.enabled = amm_node["enabled"].as<bool>();
+            }
+            if (amm_node["max_pools"]) {
+                config.amm.max_pools = amm_node["max_pools"].as<int>();
+            }
+            if (amm_node["bootstrap_batch_size"]) {
+                config.amm.bootstrap_batch_size = amm_node["bootstrap_batch_size"].as<int>();
+            }
+            if (amm_node["bootstrap_flush_ms"]) {
+                config.amm.bootstrap_flush_ms = amm_node["bootstrap_flush_ms"].as<int>();
+            }
+            if (amm_node["uniswap_v2_factory"]) {
+                config.amm.uniswap_v2_factory = amm_node["uniswap_v2_factory"].as<std::string>();
+            }
+            if (amm_node["uniswap_v2_init_code_hash"]) {
+                config.amm.uniswap_v2_init_code_hash = amm_node["uniswap_v2_init_code_hash"].as<std::string>();
+            }
+            if (amm_node["sushiswap_factory"]) {
+                config.amm.sushiswap_factory = amm_node["sushiswap_factory"].as<std::string>();
+            }
+            if (amm_node["sushiswap_init_code_hash"]) {
+                config.amm.sushiswap_init_code_hash = amm_node["sushiswap_init_code_hash"].as<std::string>();
+            }
+            if (amm_node["uniswap_v3_factory"]) {
+                config.amm.uniswap_v3_factory = amm_node["uniswap_v3_factory"].as<std::string>();
+            }
+            if (amm_node["uniswap_v3_init_code_hash"]) {
+                config.amm.uniswap_v3_init_code_hash = amm_node["uniswap_v3_init_code_hash"].as<std::string>();
+            }
         }
         
     } catch (const std::exception& e) {
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <utility>
 #include <vector>
 #include <yaml-cpp/yaml.h>
 
@@ -19,31 +20,81 @@ struct RiskEngineConfig {
     int max_gas_price_gwei = 150;
 };
 
+struct MempoolConfig {
+    bool full_transactions = false;   // subscribe for full tx objects instead of hashes
+    int rpc_batch_size = 50;          // hashes per eth_getTransactionByHash batch
+    int rpc_batch_flush_ms = 20;      // max time a hash waits for its batch to fill
+    int rpc_fetch_threads = 2;        // concurrent batches in flight
+    int max_pending_hashes = 10000;   // hashes beyond this are dropped, not queued
+    int analysis_threads = 0;         // analysis workers, 0 = one per core
+    bool pin_analysis_threads = false; // pin each worker to its own core
+    int queue_capacity = 8192;        // analysis queue slots, rounded up to a power of two
+    int reconnect_initial_ms = 100;   // first reconnect delay, doubled per failure
+    int reconnect_max_ms = 30000;     // reconnect delay cap
+};
+
 struct APIConfig {
     int port = 8765;
-    int max_connections = 100;
+    int max_connections = 100;        // open HTTP and /ws connections; more get a 503
+    int threads = 1;                  // HTTP I/O threads, separate from ingest
+    std::string push_min_risk = "medium"; // lowest risk level pushed on /ws
+    int push_queue_messages = 1024;   // per /ws subscriber before the overflow policy applies
+    std::string push_overflow = "drop_oldest"; // drop_oldest, drop_low or disconnect
+    int opportunity_capacity = 1024;  // newest MEDIUM/HIGH analyses kept for /api/opportunities
+    int opportunity_ttl_seconds = 120;
 };
 
+// Mainnet defaults; any other key under dex.routers is watched as well
 struct DEXRouters {
-    std::string uniswap_v2;
-    std::string uniswap_v3;
-    std::string sushiswap;
+    std::string uniswap_v2 = "0x7a250d5630B4cF539739dF2C5dAcb4c659F2488D";
+    std::string uniswap_v3 = "0xE592427A0AEce92De3Edee1F18E0157C05861564";
+    std::string sushiswap = "0xd9e1cE17f2641f24aE83637ab66a2cca9C378B9F";
+    std::vector<std::pair<std::string, std::string>> additional;
+
+    // (name, address) for every configured router
+    std::vector<std::pair<std::string, std::string>> entries() const {
+        std::vector<std::pair<std::string, std::string>> all = {
+            {"uniswap_v2", uniswap_v2},
+            {"uniswap_v3", uniswap_v3},
+            {"sushiswap", sushiswap}
+        };
+        all.insert(all.end(), additional.begin(), additional.end());
+        return all;
+    }
 };
 
 struct TokenAddresses {
-    std::string weth;
-    std::string dai;
-    std::string usdc;
-    std::string usdt;
+    std::string weth = "0xC02aaA39b223FE8D0A0e5C4F27eAD9083C756Cc2";
+    std::string dai = "0x6B175474E89094C44Da98b954EedeAC495271d0F";
+    std::string usdc = "0xA0b86991c6218b36c1d19D4a2e9Eb0cE3606eB48";
+    std::string usdt = "0xdAC17F958D2ee523a2206206994597C13D831ec7";
+};
+
+// Pool-state cache used for price impact. Pools are located by CREATE2
+// from their factory and init code hash; a venue left empty is simply not
+// priced (SushiSwap has no built-in default, set both values to enable it).
+struct AmmConfig {
+    bool enabled = true;
+    int max_pools = 4096;             // pools tracked at once
+    int bootstrap_batch_size = 50;    // pools per eth_call batch
+    int bootstrap_flush_ms = 50;      // max time a new pool waits for its batch
+    std::string uniswap_v2_factory = "0x5C69bEe701ef814a2B6a3EDD4B1652CB9cc5aA6f";
+    std::string uniswap_v2_init_code_hash = "0x96e8ac4277198ff8b6f785478aa9a39f403cb768dd02cbee326c3e7da348845f";
+    std::string sushiswap_factory;
+    std::string sushiswap_init_code_hash;
+    std::string uniswap_v3_factory = "0x1F98431c8aD98523631AE4a59f267346ea31F984";
+    std::string uniswap_v3_init_code_hash = "0xe34f199b19b2b4f47f68442619d555527d244f78a3297ea89325f843f87b8b54";
 };
 
 struct AppConfig {
     RPCProvider primary_provider;
     std::vector<RPCProvider> fallback_providers;
     RiskEngineConfig risk_engine;
+    MempoolConfig mempool;
     APIConfig api;
     DEXRouters dex_routers;
     TokenAddresses tokens;
+    AmmConfig amm;
 
     static AppConfig load_from_file(const std::string& config_path = "config/config.yaml");
 };
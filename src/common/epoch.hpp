@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "common/per_thread.hpp"
+#include "common/ring_buffer.hpp"
+
+namespace mev_shield {
+
+// Epoch-based reclamation. A reader announces the global epoch in its own
+// PerThread slot for the length of a Guard; an updater that unlinked an
+// object at epoch E may free it once every active reader announced a
+// later epoch, because those readers started after the unlink.
+//
+// Entering and leaving a Guard are two stores to the reader's own cache
+// line: readers never take a lock, never write shared memory and never
+// wait for an updater. Guards nest on one thread.
+class Epoch {
+public:
+    class Guard {
+    public:
+        Guard() { enter(); }
+        ~Guard() { exit(); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // Moves the global epoch on; returns the epoch that just ended
+    static uint64_t advance() {
+        return global().fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // Smallest epoch announced by an active reader, or UINT64_MAX when no
+    // reader is inside a Guard
+    static uint64_t oldest_active() {
+        uint64_t oldest = std::numeric_limits<uint64_t>::max();
+        PerThread<ReaderSlot>::for_each([&](const ReaderSlot& slot) {
+            uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0) {
+                oldest = std::min(oldest, epoch);
+            }
+        });
+        return oldest;
+    }
+
+private:
+    struct alignas(kCacheLineSize) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};      // 0 while outside every Guard
+        uint32_t depth = 0;                  // owner only
+    };
+
+    static std::atomic<uint64_t>& global() {
+        static std::atomic<uint64_t> epoch{1};
+        return epoch;
+    }
+
+    static void enter() {
+        ReaderSlot& slot = PerThread<ReaderSlot>::local();
+        if (slot.depth++ == 0) {
+            slot.epoch.store(global().load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+    }
+
+    static void exit() {
+        ReaderSlot& slot = PerThread<ReaderSlot>::local();
+        if (--slot.depth == 0) {
+            slot.epoch.store(0, std::memory_order_release);
+        }
+    }
+};
+
+// One immutable T published by a single updater and read by any number of
+// threads (read-copy-update). Readers dereference the current pointer
+// inside an Epoch::Guard; the updater swaps in a new object and frees the
+// old ones once no reader can still hold them.
+template <typename T>
+class RcuCell {
+public:
+    explicit RcuCell(std::unique_ptr<T> initial) : current_(initial.release()) {}
+
+    // No reader may be active
+    ~RcuCell() {
+        delete current_.load(std::memory_order_relaxed);
+        for (const Retired& retired : retired_) {
+            delete retired.object;
+        }
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // Any thread; the reference stays valid while `guard` lives
+    const T& read(const Epoch::Guard& guard) const {
+        (void)guard;
+        return *current_.load(std::memory_order_seq_cst);
+    }
+
+    // Updater thread only
+    void publish(std::unique_ptr<T> next) {
+        const T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        retired_.push_back(Retired{old, Epoch::advance()});
+        reclaim();
+    }
+
+    // Updater thread only; frees what no reader can still see
+    void reclaim() {
+        if (retired_.empty()) {
+            return;
+        }
+        uint64_t oldest = Epoch::oldest_active();
+        auto kept = std::remove_if(retired_.begin(), retired_.end(), [&](const Retired& retired) {
+            if (retired.epoch < oldest) {
+                delete retired.object;
+                return true;
+            }
+            return false;
+        });
+        retired_.erase(kept, retired_.end());
+    }
+
+    size_t retired_count() const { return retired_.size(); }
+
+private:
+    struct Retired {
+        const T* object;
+        uint64_t epoch;       // epoch in which it was unlinked
+    };
+
+    std::atomic<const T*> current_;
+    std::vector<Retired> retired_;       // updater only
+};
+
+} // namespace mev_shield
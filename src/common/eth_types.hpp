@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "common/hex.hpp"
+
+namespace mev_shield {
+
+template <size_t N>
+struct FixedBytes {
+    static constexpr size_t kSize = N;
+    uint8_t bytes[N] = {};
+
+    bool operator==(const FixedBytes& other) const {
+        return std::memcmp(bytes, other.bytes, N) == 0;
+    }
+    bool operator!=(const FixedBytes& other) const {
+        return !(*this == other);
+    }
+
+    // Accepts "0x" followed by exactly 2*N hex digits, any case
+    static bool from_hex(const char* text, size_t length, FixedBytes& out) {
+        return hex::decode_fixed(text, length, out.bytes, N);
+    }
+
+    static FixedBytes from_hex(const std::string& text) {
+        FixedBytes out;
+        from_hex(text.data(), text.size(), out);
+        return out;
+    }
+
+    std::string to_hex() const {
+        std::string text(2 + 2 * N, '0');
+        text[1] = 'x';
+        hex::encode(bytes, N, &text[2]);
+        return text;
+    }
+
+    // "0x" + first bytes, NUL-terminated, for log lines; no allocation
+    template <size_t Bytes = 8>
+    void short_hex(char (&out)[2 + 2 * Bytes + 1]) const {
+        static_assert(Bytes <= N, "prefix longer than value");
+        out[0] = '0';
+        out[1] = 'x';
+        hex::encode(bytes, Bytes, out + 2);
+        out[2 + 2 * Bytes] = '\0';
+    }
+};
+
+using Hash32 = FixedBytes<32>;
+using Address = FixedBytes<20>;
+
+// Non-owning view of a byte range (std::span is C++20)
+struct ByteSpan {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+    const uint8_t& operator[](size_t i) const { return data[i]; }
+};
+
+} // namespace mev_shield
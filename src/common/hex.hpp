@@ -0,0 +1,197 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MEV_SHIELD_HEX_SIMD 1
+#endif
+
+namespace mev_shield {
+namespace hex {
+
+// 0-15 for hex digits, 0xFF for anything else
+inline uint8_t nibble(char c) {
+    if (c >= '0' && c <= '9') return static_cast<uint8_t>(c - '0');
+    if (c >= 'a' && c <= 'f') return static_cast<uint8_t>(c - 'a' + 10);
+    if (c >= 'A' && c <= 'F') return static_cast<uint8_t>(c - 'A' + 10);
+    return 0xFF;
+}
+
+inline bool has_prefix(const char* text, size_t length) {
+    return length >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+}
+
+// --- scalar kernels (reference implementation and tail handling) ---
+
+inline bool decode_scalar(const char* text, size_t bytes, uint8_t* out) {
+    for (size_t i = 0; i < bytes; ++i) {
+        uint8_t hi = nibble(text[2 * i]);
+        uint8_t lo = nibble(text[2 * i + 1]);
+        if ((hi | lo) & 0xF0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+inline void encode_scalar(const uint8_t* bytes, size_t count, char* out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < count; ++i) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+}
+
+#ifdef MEV_SHIELD_HEX_SIMD
+
+// Converts 16 ASCII characters to nibble values; `valid` gets 0xFF for
+// every lane that held a hex digit. Bytes >= 0x80 compare as negative and
+// so fall outside both ranges.
+__attribute__((target("sse4.1")))
+inline __m128i nibbles_sse(__m128i chars, __m128i& valid) {
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                           _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    const __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                           _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    valid = _mm_or_si128(is_digit, is_alpha);
+    return _mm_blendv_epi8(_mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)),
+                           _mm_sub_epi8(chars, _mm_set1_epi8('0')), is_digit);
+}
+
+__attribute__((target("sse4.1")))
+inline bool decode_sse41(const char* text, size_t bytes, uint8_t* out) {
+    // maddubs folds each (hi, lo) nibble pair into hi * 16 + lo
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        __m128i valid;
+        __m128i values = nibbles_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 2 * i)), valid);
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            return false;
+        }
+        __m128i pairs = _mm_maddubs_epi16(values, weights);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(pairs, pairs));
+    }
+    return decode_scalar(text + 2 * i, bytes - i, out + i);
+}
+
+__attribute__((target("sse4.1")))
+inline void encode_sse41(const uint8_t* bytes, size_t count, char* out) {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(input, 4), low_mask));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(input, low_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    encode_scalar(bytes + i, count - i, out + 2 * i);
+}
+
+__attribute__((target("avx2")))
+inline bool decode_avx2(const char* text, size_t bytes, uint8_t* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + 2 * i));
+        __m256i lower = _mm256_or_si256(chars, case_bit);
+        __m256i is_digit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+        __m256i is_alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+        if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != -1) {
+            return false;
+        }
+        __m256i values = _mm256_blendv_epi8(_mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)),
+                                            _mm256_sub_epi8(chars, zero), is_digit);
+        __m256i pairs = _mm256_maddubs_epi16(values, weights);
+        // packus works per 128-bit lane, so pack the two lanes explicitly
+        __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(pairs),
+                                          _mm256_extracti128_si256(pairs, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    return decode_sse41(text + 2 * i, bytes - i, out + i);
+}
+
+__attribute__((target("avx2")))
+inline void encode_avx2(const uint8_t* bytes, size_t count, char* out) {
+    const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i low_mask = _mm256_set1_epi16(0x000F);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        // Widen each byte to 16 bits so the output stays in lane order:
+        // [hi nibble, lo nibble] per input byte, then one table lookup
+        __m256i wide = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)));
+        __m256i hi = _mm256_srli_epi16(wide, 4);
+        __m256i lo = _mm256_slli_epi16(_mm256_and_si256(wide, low_mask), 8);
+        __m256i chars = _mm256_shuffle_epi8(digits, _mm256_or_si256(hi, lo));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), chars);
+    }
+    encode_sse41(bytes + i, count - i, out + 2 * i);
+}
+
+#endif  // MEV_SHIELD_HEX_SIMD
+
+// --- runtime dispatch ---
+
+struct Kernels {
+    const char* name;
+    bool (*decode)(const char* text, size_t bytes, uint8_t* out);
+    void (*encode)(const uint8_t* bytes, size_t count, char* out);
+};
+
+// Chosen once from CPUID on first use
+inline const Kernels& kernels() {
+    static const Kernels selected = [] {
+#ifdef MEV_SHIELD_HEX_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Kernels{"avx2", &decode_avx2, &encode_avx2};
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return Kernels{"sse4.1", &decode_sse41, &encode_sse41};
+        }
+#endif
+        return Kernels{"scalar", &decode_scalar, &encode_scalar};
+    }();
+    return selected;
+}
+
+// Decodes 2*bytes hex digits (no prefix). Returns false on a non-hex digit.
+inline bool decode(const char* text, size_t bytes, uint8_t* out) {
+    // Below one SSE block the call through the table costs more than it saves
+    if (bytes < 8) {
+        return decode_scalar(text, bytes, out);
+    }
+    return kernels().decode(text, bytes, out);
+}
+
+// Writes 2*bytes lowercase hex digits (no prefix, no terminator)
+inline void encode(const uint8_t* bytes, size_t count, char* out) {
+    if (count < 16) {
+        encode_scalar(bytes, count, out);
+        return;
+    }
+    kernels().encode(bytes, count, out);
+}
+
+// "0x"-prefixed fixed-width field such as a hash or an address
+inline bool decode_fixed(const char* text, size_t length, uint8_t* out, size_t bytes) {
+    if (!has_prefix(text, length) || length != 2 + 2 * bytes) {
+        return false;
+    }
+    return decode(text + 2, bytes, out);
+}
+
+} // namespace hex
+} // namespace mev_shield
@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mev_shield {
+namespace keccak {
+
+// Keccak-256 as used by Ethereum (original 0x01 padding, not SHA3-256's
+// 0x06). Everything is constexpr so function selectors and event topics can
+// be computed from their signatures at compile time; the same code serves
+// the occasional runtime hash.
+
+constexpr uint64_t kRoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+constexpr unsigned kRotations[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+constexpr unsigned kPiLanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+constexpr size_t kRate = 136;  // bytes absorbed per permutation for a 256-bit digest
+
+constexpr uint64_t rotl(uint64_t value, unsigned shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+constexpr void permute(uint64_t (&state)[25]) {
+    for (int round = 0; round < 24; ++round) {
+        uint64_t columns[5] = {};
+        for (int i = 0; i < 5; ++i) {
+            columns[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
+        }
+        for (int i = 0; i < 5; ++i) {
+            uint64_t t = columns[(i + 4) % 5] ^ rotl(columns[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                state[j + i] ^= t;
+            }
+        }
+
+        uint64_t carried = state[1];
+        for (int i = 0; i < 24; ++i) {
+            unsigned lane = kPiLanes[i];
+            uint64_t next = state[lane];
+            state[lane] = rotl(carried, kRotations[i]);
+            carried = next;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            uint64_t row[5] = {state[j], state[j + 1], state[j + 2], state[j + 3], state[j + 4]};
+            for (int i = 0; i < 5; ++i) {
+                state[j + i] = row[i] ^ (~row[(i + 1) % 5] & row[(i + 2) % 5]);
+            }
+        }
+
+        state[0] ^= kRoundConstants[round];
+    }
+}
+
+// Byte source is generic so string literals and byte buffers share one path
+template <typename Byte>
+constexpr std::array<uint8_t, 32> hash256(const Byte* data, size_t length) {
+    uint64_t state[25] = {};
+    size_t offset = 0;
+    while (length - offset >= kRate) {
+        for (size_t i = 0; i < kRate; ++i) {
+            state[i / 8] ^= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * (i % 8));
+        }
+        permute(state);
+        offset += kRate;
+    }
+
+    size_t tail = length - offset;
+    for (size_t i = 0; i < tail; ++i) {
+        state[i / 8] ^= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * (i % 8));
+    }
+    state[tail / 8] ^= uint64_t{0x01} << (8 * (tail % 8));
+    state[(kRate - 1) / 8] ^= uint64_t{0x80} << (8 * ((kRate - 1) % 8));
+    permute(state);
+
+    std::array<uint8_t, 32> digest{};
+    for (size_t i = 0; i < 32; ++i) {
+        digest[i] = static_cast<uint8_t>(state[i / 8] >> (8 * (i % 8)));
+    }
+    return digest;
+}
+
+constexpr size_t length_of(const char* text) {
+    size_t length = 0;
+    while (text[length] != '\0') {
+        ++length;
+    }
+    return length;
+}
+
+// First four bytes of keccak256(signature), big-endian, e.g.
+// selector("transfer(address,uint256)") == 0xa9059cbb
+constexpr uint32_t selector(const char* signature) {
+    std::array<uint8_t, 32> digest = hash256(signature, length_of(signature));
+    return (uint32_t{digest[0]} << 24) | (uint32_t{digest[1]} << 16) |
+           (uint32_t{digest[2]} << 8) | uint32_t{digest[3]};
+}
+
+static_assert(selector("transfer(address,uint256)") == 0xa9059cbb, "keccak256 self-check");
+
+} // namespace keccak
+} // namespace mev_shield
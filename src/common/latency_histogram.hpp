@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common/per_thread.hpp"
+
+namespace mev_shield {
+
+// Log-linear (HDR-style) histogram of nanosecond durations: exact below
+// 128 ns, then 64 buckets per power of two, so every recorded value is
+// reported within 1.6% up to ~18 minutes. One thread records; any thread
+// may read, which is why the counters are relaxed atomics.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 7;
+    static constexpr unsigned kMaxBits = 40;
+    static constexpr size_t kHalf = size_t{1} << (kSubBucketBits - 1);
+    static constexpr size_t kBuckets = (kMaxBits - kSubBucketBits + 2) * kHalf;
+
+    static size_t bucket_of(uint64_t ns) {
+        if (ns < (uint64_t{1} << kSubBucketBits)) {
+            return static_cast<size_t>(ns);
+        }
+        unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(ns));
+        if (msb >= kMaxBits) {
+            return kBuckets - 1;
+        }
+        unsigned shift = msb - (kSubBucketBits - 1);
+        return shift * kHalf + static_cast<size_t>(ns >> shift);
+    }
+
+    // Largest value that lands in `bucket`
+    static uint64_t bucket_ceiling(size_t bucket) {
+        if (bucket < (size_t{1} << kSubBucketBits)) {
+            return bucket;
+        }
+        unsigned shift = static_cast<unsigned>(bucket / kHalf - 1);
+        uint64_t mantissa = bucket - shift * kHalf;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    // Single writer: a load and a store, no locked read-modify-write
+    void record(uint64_t ns) {
+        std::atomic<uint64_t>& count = counts_[bucket_of(ns)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        if (ns > max_.load(std::memory_order_relaxed)) {
+            max_.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void add_to(std::vector<uint64_t>& counts, uint64_t& sum, uint64_t& max) const {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts[i] += counts_[i].load(std::memory_order_relaxed);
+        }
+        sum += sum_.load(std::memory_order_relaxed);
+        max = std::max(max, max_.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Pipeline stages timed in MempoolMonitor and its helpers
+enum class Stage : uint8_t {
+    FrameReceive,    // whole websocket frame handler on the I/O thread
+    Parse,           // JSON parse of one frame
+    Fetch,           // eth_getTransactionByHash batch round trip
+    Decode,          // transaction object -> PendingTransaction
+    Queue,           // wait in the ingest ring before a worker takes it
+    Analyze,         // RiskEngine::analyze_transaction
+    Dispatch,        // risk handler and result logging
+    Count
+};
+
+constexpr size_t kStageCount = static_cast<size_t>(Stage::Count);
+
+inline const char* stage_name(Stage stage) {
+    static const char* const kNames[kStageCount] = {
+        "frame_receive", "parse", "fetch", "decode", "queue", "analyze", "dispatch"};
+    return kNames[static_cast<size_t>(stage)];
+}
+
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t sum_ns = 0;
+};
+
+// Process-wide stage timings. Each thread records into its own set of
+// histograms (see PerThread), so recording never shares a cache line or
+// takes a lock; summary() merges every set on demand.
+class StageLatency {
+public:
+    static StageLatency& get_instance() {
+        static StageLatency instance;
+        return instance;
+    }
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void record(Stage stage, uint64_t ns) {
+        PerThread<StageSet>::local().stages[static_cast<size_t>(stage)].record(ns);
+    }
+
+    // Cumulative since start
+    LatencySummary summary(Stage stage) const {
+        std::vector<uint64_t> counts(LatencyHistogram::kBuckets, 0);
+        LatencySummary summary;
+        PerThread<StageSet>::for_each([&](const StageSet& set) {
+            set.stages[static_cast<size_t>(stage)].add_to(counts, summary.sum_ns, summary.max_ns);
+        });
+        for (uint64_t count : counts) {
+            summary.count += count;
+        }
+        // Bucket ceilings can overshoot the largest value actually seen
+        summary.p50_ns = std::min(percentile(counts, summary.count, 0.50), summary.max_ns);
+        summary.p99_ns = std::min(percentile(counts, summary.count, 0.99), summary.max_ns);
+        summary.p999_ns = std::min(percentile(counts, summary.count, 0.999), summary.max_ns);
+        return summary;
+    }
+
+private:
+    struct StageSet {
+        std::array<LatencyHistogram, kStageCount> stages;
+    };
+
+    StageLatency() = default;
+
+    static uint64_t percentile(const std::vector<uint64_t>& counts, uint64_t total, double quantile) {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total)));
+        rank = std::max<uint64_t>(1, std::min(rank, total));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return LatencyHistogram::bucket_ceiling(i);
+            }
+        }
+        return 0;
+    }
+};
+
+// Records the time from construction to destruction under `stage`
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage) : stage_(stage), start_(StageLatency::now_ns()) {}
+    ~StageTimer() { StageLatency::get_instance().record(stage_, StageLatency::now_ns() - start_); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Stage stage_;
+    uint64_t start_;
+};
+
+} // namespace mev_shield
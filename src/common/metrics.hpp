@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "common/per_thread.hpp"
+#include "common/ring_buffer.hpp"
+
+namespace mev_shield {
+
+// Hot-path event counters. Every thread increments its own padded slot
+// with a plain load and store, so there is no contended read-modify-write
+// anywhere; totals are summed across slots only when scraped.
+enum class Counter : uint8_t {
+    FramesReceived,
+    ParseErrors,
+    AnalyzedLow,            // indexed by TransactionAnalysis::RiskLevel
+    AnalyzedMedium,
+    AnalyzedHigh,
+    ProfitGwei,             // estimated MEV profit of MEDIUM and HIGH results
+    Count
+};
+
+constexpr size_t kCounterCount = static_cast<size_t>(Counter::Count);
+
+class Metrics {
+public:
+    static void add(Counter counter, uint64_t amount = 1) {
+        std::atomic<uint64_t>& value = PerThread<CounterSlot>::local().values[static_cast<size_t>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static uint64_t total(Counter counter) {
+        uint64_t sum = 0;
+        PerThread<CounterSlot>::for_each([&](const CounterSlot& slot) {
+            sum += slot.values[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        });
+        return sum;
+    }
+
+private:
+    struct alignas(kCacheLineSize) CounterSlot {
+        std::array<std::atomic<uint64_t>, kCounterCount> values{};
+    };
+};
+
+} // namespace mev_shield
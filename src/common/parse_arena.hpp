@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <rapidjson/allocators.h>
+#include <rapidjson/document.h>
+
+namespace mev_shield {
+
+// Fixed scratch memory for parsing one JSON message at a time. Both the
+// DOM nodes and rapidjson's parse stack live in preallocated buffers that
+// are rewound by reset(), so a thread that parses every message through
+// its own arena performs no heap allocation per message. Messages larger
+// than the buffers spill into heap chunks, which reset() releases again.
+//
+// Not thread safe: give each parsing thread its own arena.
+class ParseArena {
+public:
+    using Allocator = rapidjson::MemoryPoolAllocator<>;
+    // Same value type as rapidjson::Document, so parsed values can be
+    // passed to anything that takes a rapidjson::Value
+    using Document = rapidjson::GenericDocument<rapidjson::UTF8<>, Allocator, Allocator>;
+
+    static constexpr size_t kDefaultValueBytes = 64 * 1024;
+    static constexpr size_t kDefaultStackBytes = 16 * 1024;
+
+    explicit ParseArena(size_t value_bytes = kDefaultValueBytes,
+                        size_t stack_bytes = kDefaultStackBytes)
+        : value_bytes_(value_bytes)
+        , stack_bytes_(stack_bytes)
+        , value_buffer_(new char[value_bytes])
+        , stack_buffer_(new char[stack_bytes])
+        , values_(value_buffer_.get(), value_bytes)
+        , stack_(stack_buffer_.get(), stack_bytes) {}
+
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator=(const ParseArena&) = delete;
+
+    // Invalidates every value parsed since the previous reset
+    void reset() {
+        if (values_.Capacity() > value_bytes_ || stack_.Capacity() > stack_bytes_) {
+            spills_++;
+        }
+        values_.Clear();
+        stack_.Clear();
+    }
+
+    // A document whose nodes and parse stack come from this arena. With
+    // ParseInsitu, strings point into the parsed buffer instead, so that
+    // buffer must outlive the values as well.
+    Document make_document() {
+        return Document(&values_, stack_bytes_ / 2, &stack_);
+    }
+
+    // Messages that outgrew the fixed buffers since construction
+    size_t spill_count() const { return spills_; }
+
+private:
+    size_t value_bytes_;
+    size_t stack_bytes_;
+    std::unique_ptr<char[]> value_buffer_;
+    std::unique_ptr<char[]> stack_buffer_;
+    Allocator values_;
+    Allocator stack_;
+    size_t spills_ = 0;
+};
+
+} // namespace mev_shield
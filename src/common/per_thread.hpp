@@ -0,0 +1,77 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mev_shield {
+
+// One process-wide Slot per live thread, for statistics that are written
+// on hot paths and read rarely. A thread claims a slot on first use and
+// hands it back when it exits; the slot keeps its contents and is reused
+// by the next new thread, so totals survive thread churn and the slot
+// count stays at the peak number of concurrent threads.
+//
+// Slots are separate heap objects, so writers never share a cache line.
+// Readers visit every slot under a mutex that writers never take; Slot
+// members must therefore be safe to read while their owner writes them
+// (relaxed atomics written by their single owner).
+template <typename Slot>
+class PerThread {
+public:
+    static Slot& local() {
+        thread_local Lease lease;
+        return lease.entry->slot;
+    }
+
+    template <typename Fn>
+    static void for_each(Fn&& fn) {
+        Registry& registry = get_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& entry : registry.entries) {
+            fn(static_cast<const Slot&>(entry->slot));
+        }
+    }
+
+private:
+    struct Entry {
+        Slot slot;
+        bool in_use = false;     // guarded by Registry::mutex
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Entry>> entries;
+    };
+
+    struct Lease {
+        Entry* entry;
+
+        Lease() {
+            Registry& registry = get_registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (auto& candidate : registry.entries) {
+                if (!candidate->in_use) {
+                    candidate->in_use = true;
+                    entry = candidate.get();
+                    return;
+                }
+            }
+            registry.entries.push_back(std::make_unique<Entry>());
+            entry = registry.entries.back().get();
+            entry->in_use = true;
+        }
+
+        ~Lease() {
+            Registry& registry = get_registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            entry->in_use = false;
+        }
+    };
+
+    static Registry& get_registry() {
+        static Registry registry;
+        return registry;
+    }
+};
+
+} // namespace mev_shield
@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace mev_shield {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Smallest power of two >= n, and at least 2: a valid RingBuffer capacity
+// and a mask-indexable table size
+inline size_t round_up_pow2(size_t n) {
+    size_t size = 2;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// Bounded lock-free queue (Vyukov's sequence-numbered ring). Any number of
+// producers and consumers may call try_push/try_pop concurrently, which
+// covers the SPSC and MPSC cases as well. Each slot carries a sequence
+// number telling producers and consumers whose turn it is, so neither side
+// ever blocks: a full ring rejects the push, an empty ring fails the pop.
+//
+// Capacity must be a power of two so the slot index is a mask, and the
+// head/tail counters sit on their own cache lines so producers and
+// consumers do not false-share.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity)
+        : capacity_(capacity)
+        , mask_(capacity - 1)
+        , slots_(new Slot[capacity]) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("RingBuffer capacity must be a power of two");
+        }
+        for (size_t i = 0; i < capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    bool try_push(T&& value) {
+        return try_push_with([&](T& slot) { slot = std::move(value); });
+    }
+
+    bool try_pop(T& out) {
+        return try_pop_with([&](T& slot) { out = std::move(slot); });
+    }
+
+    // Fills the claimed slot in place. Lets callers reuse the capacity of a
+    // slot's buffers instead of moving a freshly allocated value in.
+    template <typename Fill>
+    bool try_push_with(Fill&& fill) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(slot.value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Hands the claimed slot to consume() in place before releasing it
+    template <typename Consume>
+    bool try_pop_with(Consume&& consume) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    consume(slot.value);
+                    slot.sequence.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate under concurrency; good enough for gauges
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(kCacheLineSize) Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    char padding_[kCacheLineSize - sizeof(std::atomic<size_t>)] = {};
+};
+
+} // namespace mev_shield
@@ -0,0 +1,115 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mev_shield {
+namespace sha1 {
+
+// SHA-1, needed only for the WebSocket handshake (RFC 6455 derives
+// Sec-WebSocket-Accept from it). Not for anything security sensitive.
+
+inline uint32_t rotl(uint32_t value, unsigned shift) {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+inline void compress(uint32_t (&state)[5], const uint8_t* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t{block[4 * i]} << 24) | (uint32_t{block[4 * i + 1]} << 16) |
+               (uint32_t{block[4 * i + 2]} << 8) | uint32_t{block[4 * i + 3]};
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl(b, 30);
+        b = a;
+        a = temp;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+inline std::array<uint8_t, 20> hash(const std::string& input) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t full = input.size() / 64 * 64;
+    for (size_t offset = 0; offset < full; offset += 64) {
+        compress(state, reinterpret_cast<const uint8_t*>(input.data()) + offset);
+    }
+
+    uint8_t tail[128] = {};
+    size_t rest = input.size() - full;
+    for (size_t i = 0; i < rest; ++i) {
+        tail[i] = static_cast<uint8_t>(input[full + i]);
+    }
+    tail[rest] = 0x80;
+    size_t tail_size = rest < 56 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(input.size()) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tail_size - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+    for (size_t offset = 0; offset < tail_size; offset += 64) {
+        compress(state, tail + offset);
+    }
+
+    std::array<uint8_t, 20> digest;
+    for (int i = 0; i < 5; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+inline std::string base64(const uint8_t* bytes, size_t count) {
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((count + 2) / 3 * 4);
+    for (size_t i = 0; i < count; i += 3) {
+        uint32_t group = uint32_t{bytes[i]} << 16;
+        if (i + 1 < count) {
+            group |= uint32_t{bytes[i + 1]} << 8;
+        }
+        if (i + 2 < count) {
+            group |= bytes[i + 2];
+        }
+        out += kAlphabet[(group >> 18) & 63];
+        out += kAlphabet[(group >> 12) & 63];
+        out += i + 1 < count ? kAlphabet[(group >> 6) & 63] : '=';
+        out += i + 2 < count ? kAlphabet[group & 63] : '=';
+    }
+    return out;
+}
+
+// Sec-WebSocket-Accept for a client's Sec-WebSocket-Key
+inline std::string websocket_accept(const std::string& key) {
+    std::array<uint8_t, 20> digest = hash(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+    return base64(digest.data(), digest.size());
+}
+
+} // namespace sha1
+} // namespace mev_shield
@@ -0,0 +1,390 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "common/hex.hpp"
+
+namespace mev_shield {
+
+// Fixed-width 256-bit unsigned integer, the native EVM word. Limbs are
+// little-endian: limbs[0] holds the least significant 64 bits. Arithmetic
+// wraps modulo 2^256 like the EVM; use checked_add/checked_mul where an
+// overflow must be detected instead.
+struct Uint256 {
+    uint64_t limbs[4] = {0, 0, 0, 0};
+
+    static Uint256 from_u64(uint64_t value) {
+        Uint256 out;
+        out.limbs[0] = value;
+        return out;
+    }
+
+    bool is_zero() const {
+        return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0;
+    }
+
+    bool fits_u64() const {
+        return (limbs[1] | limbs[2] | limbs[3]) == 0;
+    }
+
+    uint64_t low_u64() const { return limbs[0]; }
+
+    // Index of the highest set bit plus one; 0 for zero
+    unsigned bit_length() const {
+        for (int i = 3; i >= 0; --i) {
+            if (limbs[i] != 0) {
+                return 64 * i + 64 - static_cast<unsigned>(__builtin_clzll(limbs[i]));
+            }
+        }
+        return 0;
+    }
+
+    // Parses a JSON-RPC quantity ("0x" followed by 1-64 hex digits)
+    static bool from_hex(const char* text, size_t length, Uint256& out) {
+        out = Uint256{};
+        if (!hex::has_prefix(text, length)) {
+            return false;
+        }
+        text += 2;
+        length -= 2;
+        if (length > 64) {
+            return false;
+        }
+        // Left-pad to whole bytes and decode as the tail of a big-endian word
+        size_t bytes = (length + 1) / 2;
+        char padded[64];
+        padded[0] = '0';
+        std::memcpy(padded + (length & 1), text, length);
+        uint8_t word[32] = {};
+        if (!hex::decode(padded, bytes, word + 32 - bytes)) {
+            return false;
+        }
+        out = from_be_bytes(word);
+        return true;
+    }
+
+    // Big-endian 32-byte word, as found in ABI-encoded calldata and eth_call results
+    static Uint256 from_be_bytes(const uint8_t* bytes) {
+        Uint256 out;
+        for (int limb = 0; limb < 4; ++limb) {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; ++i) {
+                value = (value << 8) | bytes[(3 - limb) * 8 + i];
+            }
+            out.limbs[limb] = value;
+        }
+        return out;
+    }
+
+    // JSON-RPC quantity form: "0x" and no leading zeros ("0x0" for zero)
+    std::string to_hex() const {
+        static const char digits[] = "0123456789abcdef";
+        char buffer[2 + 64];
+        size_t length = 2;
+        buffer[0] = '0';
+        buffer[1] = 'x';
+        unsigned nibbles = (bit_length() + 3) / 4;
+        if (nibbles == 0) {
+            buffer[length++] = '0';
+        }
+        for (unsigned i = nibbles; i-- > 0;) {
+            buffer[length++] = digits[(limbs[i / 16] >> (4 * (i % 16))) & 0x0F];
+        }
+        return std::string(buffer, length);
+    }
+
+    // Writes the base-10 form without a terminator; returns its length.
+    // `out` needs room for 78 digits.
+    size_t to_decimal(char* out) const {
+        constexpr uint64_t kChunk = 10000000000000000000ULL;  // 10^19
+        constexpr int kChunkDigits = 19;
+        if (is_zero()) {
+            out[0] = '0';
+            return 1;
+        }
+        // Peel off 19 digits at a time, least significant chunk first
+        uint64_t chunks[5];
+        int count = 0;
+        Uint256 rest = *this;
+        while (!rest.is_zero()) {
+            uint64_t remainder = 0;
+            rest = rest.divmod_u64(kChunk, remainder);
+            chunks[count++] = remainder;
+        }
+        size_t length = 0;
+        for (int c = count - 1; c >= 0; --c) {
+            char digits[kChunkDigits];
+            uint64_t value = chunks[c];
+            for (int d = kChunkDigits - 1; d >= 0; --d) {
+                digits[d] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            int skip = 0;
+            if (c == count - 1) {
+                while (skip < kChunkDigits - 1 && digits[skip] == '0') {
+                    ++skip;
+                }
+            }
+            for (int d = skip; d < kChunkDigits; ++d) {
+                out[length++] = digits[d];
+            }
+        }
+        return length;
+    }
+
+    std::string to_decimal() const {
+        char buffer[78];
+        return std::string(buffer, to_decimal(buffer));
+    }
+
+    double to_double() const {
+        return static_cast<double>(limbs[3]) * 6277101735386680763835789423207666416102355444464034512896.0 +
+               static_cast<double>(limbs[2]) * 340282366920938463463374607431768211456.0 +
+               static_cast<double>(limbs[1]) * 18446744073709551616.0 +
+               static_cast<double>(limbs[0]);
+    }
+
+    // --- comparison ---
+
+    friend bool operator==(const Uint256& a, const Uint256& b) {
+        return ((a.limbs[0] ^ b.limbs[0]) | (a.limbs[1] ^ b.limbs[1]) |
+                (a.limbs[2] ^ b.limbs[2]) | (a.limbs[3] ^ b.limbs[3])) == 0;
+    }
+    friend bool operator!=(const Uint256& a, const Uint256& b) { return !(a == b); }
+    friend bool operator<(const Uint256& a, const Uint256& b) {
+        for (int i = 3; i >= 0; --i) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return a.limbs[i] < b.limbs[i];
+            }
+        }
+        return false;
+    }
+    friend bool operator>(const Uint256& a, const Uint256& b) { return b < a; }
+    friend bool operator<=(const Uint256& a, const Uint256& b) { return !(b < a); }
+    friend bool operator>=(const Uint256& a, const Uint256& b) { return !(a < b); }
+
+    // --- arithmetic ---
+
+    // Returns false (and the wrapped sum) on overflow
+    static bool checked_add(const Uint256& a, const Uint256& b, Uint256& out) {
+        unsigned __int128 carry = 0;
+        for (int i = 0; i < 4; ++i) {
+            carry += static_cast<unsigned __int128>(a.limbs[i]) + b.limbs[i];
+            out.limbs[i] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        return carry == 0;
+    }
+
+    friend Uint256 operator+(const Uint256& a, const Uint256& b) {
+        Uint256 out;
+        checked_add(a, b, out);
+        return out;
+    }
+
+    friend Uint256 operator-(const Uint256& a, const Uint256& b) {
+        Uint256 out;
+        uint64_t borrow = 0;
+        for (int i = 0; i < 4; ++i) {
+            uint64_t lhs = a.limbs[i];
+            uint64_t diff = lhs - b.limbs[i] - borrow;
+            borrow = (lhs < b.limbs[i]) || (lhs - b.limbs[i] < borrow) ? 1 : 0;
+            out.limbs[i] = diff;
+        }
+        return out;
+    }
+
+    // Schoolbook 4x4 limbs; returns false (and the low 256 bits) on overflow
+    static bool checked_mul(const Uint256& a, const Uint256& b, Uint256& out) {
+        uint64_t result[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (int i = 0; i < 4; ++i) {
+            if (a.limbs[i] == 0) {
+                continue;
+            }
+            unsigned __int128 carry = 0;
+            for (int j = 0; j < 4; ++j) {
+                carry += static_cast<unsigned __int128>(a.limbs[i]) * b.limbs[j] + result[i + j];
+                result[i + j] = static_cast<uint64_t>(carry);
+                carry >>= 64;
+            }
+            result[i + 4] = static_cast<uint64_t>(carry);
+        }
+        for (int i = 0; i < 4; ++i) {
+            out.limbs[i] = result[i];
+        }
+        return (result[4] | result[5] | result[6] | result[7]) == 0;
+    }
+
+    friend Uint256 operator*(const Uint256& a, const Uint256& b) {
+        Uint256 out;
+        checked_mul(a, b, out);
+        return out;
+    }
+
+    // Fast path for the common small divisor (wei per ether, 10^19 chunks)
+    Uint256 divmod_u64(uint64_t divisor, uint64_t& remainder) const {
+        Uint256 quotient;
+        unsigned __int128 rest = 0;
+        for (int i = 3; i >= 0; --i) {
+            rest = (rest << 64) | limbs[i];
+            quotient.limbs[i] = static_cast<uint64_t>(rest / divisor);
+            rest %= divisor;
+        }
+        remainder = static_cast<uint64_t>(rest);
+        return quotient;
+    }
+
+    // Division by zero yields zero quotient and remainder, as in the EVM
+    static void divmod(const Uint256& dividend, const Uint256& divisor,
+                       Uint256& quotient, Uint256& remainder) {
+        quotient = Uint256{};
+        remainder = Uint256{};
+        if (divisor.is_zero()) {
+            return;
+        }
+        if (divisor.fits_u64()) {
+            uint64_t rest = 0;
+            quotient = dividend.divmod_u64(divisor.limbs[0], rest);
+            remainder = from_u64(rest);
+            return;
+        }
+        if (dividend < divisor) {
+            remainder = dividend;
+            return;
+        }
+        divmod_knuth(dividend, divisor, quotient, remainder);
+    }
+
+    friend Uint256 operator/(const Uint256& a, const Uint256& b) {
+        Uint256 quotient, remainder;
+        divmod(a, b, quotient, remainder);
+        return quotient;
+    }
+
+    friend Uint256 operator%(const Uint256& a, const Uint256& b) {
+        Uint256 quotient, remainder;
+        divmod(a, b, quotient, remainder);
+        return remainder;
+    }
+
+    friend Uint256 operator<<(const Uint256& a, unsigned shift) {
+        Uint256 out;
+        if (shift >= 256) {
+            return out;
+        }
+        unsigned limb_shift = shift / 64;
+        unsigned bit_shift = shift % 64;
+        for (int i = 3; i >= static_cast<int>(limb_shift); --i) {
+            uint64_t value = a.limbs[i - limb_shift] << bit_shift;
+            if (bit_shift != 0 && i - static_cast<int>(limb_shift) - 1 >= 0) {
+                value |= a.limbs[i - limb_shift - 1] >> (64 - bit_shift);
+            }
+            out.limbs[i] = value;
+        }
+        return out;
+    }
+
+    friend Uint256 operator>>(const Uint256& a, unsigned shift) {
+        Uint256 out;
+        if (shift >= 256) {
+            return out;
+        }
+        unsigned limb_shift = shift / 64;
+        unsigned bit_shift = shift % 64;
+        for (unsigned i = 0; i + limb_shift < 4; ++i) {
+            uint64_t value = a.limbs[i + limb_shift] >> bit_shift;
+            if (bit_shift != 0 && i + limb_shift + 1 < 4) {
+                value |= a.limbs[i + limb_shift + 1] << (64 - bit_shift);
+            }
+            out.limbs[i] = value;
+        }
+        return out;
+    }
+
+private:
+    // Knuth's algorithm D on 64-bit limbs (Hacker's Delight divmnu64).
+    // Requires a divisor of at least two limbs and dividend >= divisor.
+    static void divmod_knuth(const Uint256& dividend, const Uint256& divisor,
+                             Uint256& quotient, Uint256& remainder) {
+        int n = (divisor.bit_length() + 63) / 64;
+        int m = (dividend.bit_length() + 63) / 64;
+
+        // Normalize so the divisor's top limb has its high bit set
+        unsigned shift = static_cast<unsigned>(__builtin_clzll(divisor.limbs[n - 1]));
+        uint64_t vn[4];
+        uint64_t un[5];
+        for (int i = n - 1; i > 0; --i) {
+            vn[i] = (divisor.limbs[i] << shift) |
+                    (shift ? divisor.limbs[i - 1] >> (64 - shift) : 0);
+        }
+        vn[0] = divisor.limbs[0] << shift;
+        un[m] = shift ? dividend.limbs[m - 1] >> (64 - shift) : 0;
+        for (int i = m - 1; i > 0; --i) {
+            un[i] = (dividend.limbs[i] << shift) |
+                    (shift ? dividend.limbs[i - 1] >> (64 - shift) : 0);
+        }
+        un[0] = dividend.limbs[0] << shift;
+
+        for (int j = m - n; j >= 0; --j) {
+            unsigned __int128 numerator =
+                (static_cast<unsigned __int128>(un[j + n]) << 64) | un[j + n - 1];
+            unsigned __int128 qhat = numerator / vn[n - 1];
+            unsigned __int128 rhat = numerator % vn[n - 1];
+            while ((qhat >> 64) != 0 ||
+                   qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if ((rhat >> 64) != 0) {
+                    break;
+                }
+            }
+
+            // Multiply and subtract qhat * vn from the current window
+            __int128 borrow = 0;
+            __int128 t = 0;
+            for (int i = 0; i < n; ++i) {
+                unsigned __int128 product = qhat * vn[i];
+                t = static_cast<__int128>(un[i + j]) - borrow - static_cast<uint64_t>(product);
+                un[i + j] = static_cast<uint64_t>(t);
+                borrow = static_cast<__int128>(product >> 64) - (t >> 64);
+            }
+            t = static_cast<__int128>(un[j + n]) - borrow;
+            un[j + n] = static_cast<uint64_t>(t);
+
+            quotient.limbs[j] = static_cast<uint64_t>(qhat);
+            if (t < 0) {
+                // qhat was one too large: add the divisor back
+                quotient.limbs[j]--;
+                unsigned __int128 carry = 0;
+                for (int i = 0; i < n; ++i) {
+                    carry += static_cast<unsigned __int128>(un[i + j]) + vn[i];
+                    un[i + j] = static_cast<uint64_t>(carry);
+                    carry >>= 64;
+                }
+                un[j + n] += static_cast<uint64_t>(carry);
+            }
+        }
+
+        for (int i = 0; i < n; ++i) {
+            remainder.limbs[i] = (un[i] >> shift) |
+                                 (shift && i + 1 <= n ? un[i + 1] << (64 - shift) : 0);
+        }
+    }
+};
+
+constexpr uint64_t kWeiPerEther = 1000000000000000000ULL;
+
+// Exact integer part plus the fractional wei, so whole-ether amounts above
+// 2^53 wei convert without the rounding of a single to_double() / 1e18
+inline double wei_to_ether(const Uint256& wei) {
+    uint64_t fraction = 0;
+    Uint256 whole = wei.divmod_u64(kWeiPerEther, fraction);
+    return whole.to_double() + static_cast<double>(fraction) / static_cast<double>(kWeiPerEther);
+}
+
+inline Uint256 ether_to_wei(uint64_t ether) {
+    return Uint256::from_u64(ether) * Uint256::from_u64(kWeiPerEther);
+}
+
+} // namespace mev_shield
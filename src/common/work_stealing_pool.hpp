@@ -0,0 +1,266 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "common/logger.hpp"
+#include "common/ring_buffer.hpp"
+
+namespace mev_shield {
+
+// Fixed pool of workers with one deque each. A worker pops its own deque
+// from the back (most recently added, still warm in cache), refills it in
+// chunks from an optional shared source such as the ingest ring, and when
+// both are empty steals half of another worker's deque from the front.
+// Bursts pulled by one worker are thereby spread across all cores without
+// a central lock.
+//
+// Every worker owns a WorkerState built by the factory on its own thread,
+// so per-worker engines and scratch buffers are never shared.
+//
+// Tasks are swapped, never move-assigned, and a worker keeps the objects
+// it has finished with as spares for its next pull from the source. Task
+// buffers therefore circulate between the source and the workers with
+// their capacity intact instead of being freed and reallocated per task.
+template <typename Task, typename WorkerState>
+class WorkStealingPool {
+public:
+    using StateFactory = std::function<std::unique_ptr<WorkerState>(size_t worker)>;
+    using TaskHandler = std::function<void(WorkerState& state, Task& task)>;
+    using TaskSource = std::function<bool(Task& out)>;
+
+    static constexpr size_t kSourceBatch = 32;
+    // Finished tasks a worker keeps for reuse; more are released
+    static constexpr size_t kMaxSpares = 2 * kSourceBatch;
+
+    WorkStealingPool(size_t num_threads, StateFactory make_state, TaskHandler handler,
+                     bool pin_threads = false)
+        : make_state_(std::move(make_state))
+        , handler_(std::move(handler))
+        , pin_threads_(pin_threads) {
+        size_t count = num_threads > 0 ? num_threads : 1;
+        for (size_t i = 0; i < count; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    ~WorkStealingPool() {
+        stop();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Polled by idle workers; must be set before start()
+    void set_source(TaskSource source) {
+        source_ = std::move(source);
+    }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        for (size_t i = 0; i < workers_.size(); ++i) {
+            workers_[i]->thread = std::thread([this, i]() { run_worker(i); });
+            if (pin_threads_) {
+                pin_thread(workers_[i]->thread, i);
+            }
+        }
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    // Distributes externally submitted tasks round-robin
+    void submit(Task task) {
+        Worker& worker = *workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    size_t thread_count() const { return workers_.size(); }
+
+    size_t pending() const {
+        size_t total = 0;
+        for (const auto& worker : workers_) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            total += worker->tasks.size();
+        }
+        return total;
+    }
+
+    uint64_t executed_count() const {
+        uint64_t total = 0;
+        for (const auto& worker : workers_) {
+            total += worker->executed.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    uint64_t steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(kCacheLineSize) Worker {
+        mutable std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+        std::atomic<uint64_t> executed{0};
+    };
+
+    StateFactory make_state_;
+    TaskHandler handler_;
+    TaskSource source_;
+    bool pin_threads_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<uint64_t> steals_{0};
+
+    void run_worker(size_t index) {
+        Worker& self = *workers_[index];
+        std::unique_ptr<WorkerState> state = make_state_(index);
+        std::vector<Task> stolen;
+        stolen.reserve(kSourceBatch);
+        std::vector<Task> spares;
+        spares.reserve(kMaxSpares);
+        Task task{};
+        int idle_spins = 0;
+
+        while (running_.load(std::memory_order_relaxed)) {
+            if (pop_local(self, task, spares) || refill_from_source(self, task, spares) ||
+                steal(index, task, stolen, spares)) {
+                idle_spins = 0;
+                try {
+                    handler_(*state, task);
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Worker {} task exception: {}", index, e.what());
+                }
+                self.executed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            // Spin briefly for bursts, then back off to avoid burning a core
+            if (++idle_spins < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    // Makes `next` the current task and keeps the finished one as a spare
+    static void take(Task& task, Task& next, std::vector<Task>& spares) {
+        using std::swap;
+        swap(task, next);
+        if (spares.size() < kMaxSpares) {
+            spares.push_back(std::move(next));
+        }
+    }
+
+    bool pop_local(Worker& self, Task& task, std::vector<Task>& spares) {
+        Task next{};
+        {
+            std::lock_guard<std::mutex> lock(self.mutex);
+            if (self.tasks.empty()) {
+                return false;
+            }
+            next = std::move(self.tasks.back());
+            self.tasks.pop_back();
+        }
+        take(task, next, spares);
+        return true;
+    }
+
+    // Takes one task to run now and parks up to a chunk more locally, where
+    // other workers can steal them if this one falls behind. The source
+    // swaps its entries with `task` and the spares, so it gets their
+    // buffers back.
+    bool refill_from_source(Worker& self, Task& task, std::vector<Task>& spares) {
+        if (!source_ || !source_(task)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(self.mutex);
+        for (size_t i = 1; i < kSourceBatch; ++i) {
+            Task extra{};
+            if (!spares.empty()) {
+                extra = std::move(spares.back());
+                spares.pop_back();
+            }
+            if (!source_(extra)) {
+                spares.push_back(std::move(extra));
+                break;
+            }
+            self.tasks.push_back(std::move(extra));
+        }
+        return true;
+    }
+
+    bool steal(size_t index, Task& task, std::vector<Task>& stolen, std::vector<Task>& spares) {
+        for (size_t offset = 1; offset < workers_.size(); ++offset) {
+            Worker& victim = *workers_[(index + offset) % workers_.size()];
+            {
+                // Only one lock is held at a time so two thieves robbing
+                // each other cannot deadlock
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                size_t take = (victim.tasks.size() + 1) / 2;
+                for (size_t i = 0; i < take; ++i) {
+                    stolen.push_back(std::move(victim.tasks.front()));
+                    victim.tasks.pop_front();
+                }
+            }
+            if (stolen.empty()) {
+                continue;
+            }
+
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            take(task, stolen.front(), spares);
+            if (stolen.size() > 1) {
+                Worker& self = *workers_[index];
+                std::lock_guard<std::mutex> lock(self.mutex);
+                for (size_t i = 1; i < stolen.size(); ++i) {
+                    self.tasks.push_back(std::move(stolen[i]));
+                }
+            }
+            stolen.clear();
+            return true;
+        }
+        return false;
+    }
+
+    static void pin_thread(std::thread& thread, size_t index) {
+#ifdef __linux__
+        unsigned cores = std::thread::hardware_concurrency();
+        if (cores == 0) {
+            return;
+        }
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(index % cores, &cpuset);
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) != 0) {
+            LOG_WARN("Failed to pin worker {} to core {}", index, index % cores);
+        }
+#else
+        (void)thread;
+        (void)index;
+#endif
+    }
+};
+
+} // namespace mev_shield
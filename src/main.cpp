@@ -2,12 +2,15 @@
 #include <memory>
 #include <csignal>
 #include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>  // ADD THIS
 #include <string>   // ADD THIS
+#include <thread>
 #include <vector>   // ADD THIS
 #include "common/logger.hpp"
 #include "analytics/risk_engine.hpp"
+#include "network/api_server.hpp"
 #include "network/mempool_monitor.hpp"
 #include "common/config_loader.hpp"
 
@@ -18,7 +21,7 @@ void signal_handler(int) {
     running = false;
 }
 
-std::string load_websocket_url() {
+mev_shield::AppConfig load_app_config() {
     // Try multiple config locations and formats
     std::vector<std::string> config_paths = {
         "config/config.yaml",
@@ -34,7 +37,7 @@ std::string load_websocket_url() {
                 auto config = mev_shield::AppConfig::load_from_file(path);
                 if (!config.primary_provider.websocket_url.empty()) {
                     std::cout << "✅ Config loaded from: " << path << std::endl;
-                    return config.primary_provider.websocket_url;
+                    return config;
                 }
             } catch (const std::exception& e) {
                 std::cout << "❌ Config error in " << path << ": " << e.what() << std::endl;
@@ -44,7 +47,28 @@ std::string load_websocket_url() {
     
     // Fallback: Hardcoded URL
     std::cout << "⚠️  Using hardcoded WebSocket URL" << std::endl;
-    return "wss://mainnet.infura.io/ws/v3/YOUR_PROJECT_ID";
+    mev_shield::AppConfig config;
+    config.primary_provider.name = "infura";
+    config.primary_provider.websocket_url = "wss://mainnet.infura.io/ws/v3/YOUR_PROJECT_ID";
+    config.primary_provider.http_url = "https://mainnet.infura.io/v3/YOUR_PROJECT_ID";
+    return config;
+}
+
+// Queues the WETH pools of the configured stablecoins on every venue, so
+// the busiest pairs are priced from the first block instead of after
+// their first sighting
+void warm_pool_cache(mev_shield::PoolCache& pool_cache, const mev_shield::TokenAddresses& tokens) {
+    using mev_shield::Address;
+    using mev_shield::PoolVenue;
+    Address weth = Address::from_hex(tokens.weth);
+    for (const std::string& token : {tokens.usdc, tokens.usdt, tokens.dai}) {
+        Address quote = Address::from_hex(token);
+        pool_cache.request_pair(PoolVenue::UniswapV2, weth, quote, 3000);
+        pool_cache.request_pair(PoolVenue::SushiSwap, weth, quote, 3000);
+        for (uint32_t fee : {500u, 3000u, 10000u}) {
+            pool_cache.request_pair(PoolVenue::UniswapV3, weth, quote, fee);
+        }
+    }
 }
 
 int main() {
@@ -73,22 +97,41 @@ int main() {
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
     
-    // Load WebSocket URL with multiple fallbacks
-    std::string websocket_url = load_websocket_url();
+    // Load configuration with multiple fallbacks
+    mev_shield::AppConfig config = load_app_config();
     
-    LOG_INFO("Final WebSocket URL: {}", websocket_url);
+    LOG_INFO("Final WebSocket URL: {}", config.primary_provider.websocket_url);
+    LOG_INFO("Final HTTP RPC URL: {}", config.primary_provider.http_url);
     
     try {
         // Initialize components
-        auto risk_engine = std::make_shared<mev_shield::RiskEngine>();
-        auto mempool_monitor = std::make_shared<mev_shield::MempoolMonitor>(websocket_url, risk_engine);
+        std::shared_ptr<mev_shield::PoolCache> pool_cache;
+        if (config.amm.enabled) {
+            pool_cache = std::make_shared<mev_shield::PoolCache>(config.amm);
+            warm_pool_cache(*pool_cache, config.tokens);
+        }
+        auto risk_engine = std::make_shared<mev_shield::RiskEngine>(
+            config.risk_engine.min_profit_threshold_eth,
+            config.risk_engine.high_risk_slippage_percent,
+            config.dex_routers,
+            pool_cache);
+        LOG_INFO("🔀 Watching {} DEX routers", risk_engine->routers().size());
+        if (pool_cache) {
+            LOG_INFO("🏊 Pool cache enabled: {} pools queued for bootstrap", pool_cache->size());
+        }
+        // Race the primary provider against every fallback feed
+        std::vector<mev_shield::RPCProvider> providers{config.primary_provider};
+        providers.insert(providers.end(), config.fallback_providers.begin(),
+                         config.fallback_providers.end());
+        auto mempool_monitor = std::make_shared<mev_shield::MempoolMonitor>(
+            providers, config.mempool, risk_engine, config.amm);
         
         // Set up risk handler
         mempool_monitor->set_risk_handler([](const mev_shield::TransactionAnalysis& analysis) {
             if (analysis.risk_level == mev_shield::TransactionAnalysis::HIGH) {
                 LOG_WARN("🚨 HIGH RISK TRANSACTION DETECTED!");
                 LOG_WARN("   Estimated MEV Profit: {:.4f} ETH", analysis.estimated_mev_profit_eth);
-                LOG_WARN("   Reason: {}", analysis.risk_reason);
+                LOG_WARN("   Reason: {}", mev_shield::risk_reason_text(analysis.risk_reason));
             }
         });
         
@@ -97,8 +140,27 @@ int main() {
         LOG_INFO("Press Ctrl+C to stop");
         std::cout << std::endl;
         
+        // The API serves from its own threads while run() blocks this one
+        mev_shield::APIServer api_server(config.api, mempool_monitor);
+        if (!api_server.start()) {
+            LOG_WARN("⚠️ API server disabled: port {} unavailable", config.api.port);
+        }
+        
+        // The signal handler only clears `running`; this thread turns that
+        // into a stop() so run() returns and the shutdown below happens
+        std::thread shutdown_watcher([&mempool_monitor]() {
+            while (running) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            mempool_monitor->stop();
+        });
+        
         // Start monitoring
         mempool_monitor->run();
+        running = false;
+        shutdown_watcher.join();
+        mempool_monitor->stop();     // no analyses reach the push feed after this
+        api_server.stop();
         
     } catch (const std::exception& e) {
         LOG_CRITICAL("Fatal error: {}", e.what());
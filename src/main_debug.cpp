@@ -62,7 +62,7 @@ int main() {
             if (analysis.risk_level == mev_shield::TransactionAnalysis::HIGH) {
                 LOG_WARN("🚨 HIGH RISK TRANSACTION DETECTED!");
                 LOG_WARN("   Estimated MEV Profit: {:.4f} ETH", analysis.estimated_mev_profit_eth);
-                LOG_WARN("   Reason: {}", analysis.risk_reason);
+                LOG_WARN("   Reason: {}", mev_shield::risk_reason_text(analysis.risk_reason));
             }
         });
         
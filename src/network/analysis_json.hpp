@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "analytics/transaction.hpp"
+#include "analytics/transaction_analysis.hpp"
+
+namespace mev_shield {
+
+// JSON object describing one analyzed transaction, as pushed on /ws and
+// listed by /api/opportunities. Appends to `out` so callers can build
+// frames and arrays without intermediate strings.
+inline void append_analysis_json(std::string& out, const TransactionInfo& tx,
+                                 const TransactionAnalysis& analysis, uint64_t seen_ms) {
+    char number[32];
+    auto append_number = [&](const char* key, double value) {
+        std::snprintf(number, sizeof(number), "%.9g", value);
+        out += ",\"";
+        out += key;
+        out += "\":";
+        out += number;
+    };
+
+    out += "{\"hash\":\"";
+    out += tx.hash.to_hex();
+    out += "\",\"from\":\"";
+    out += tx.from.to_hex();
+    out += "\",\"to\":";
+    if (tx.has_to) {
+        out += '"';
+        out += tx.to.to_hex();
+        out += '"';
+    } else {
+        out += "null";
+    }
+    append_number("value_eth", tx.eth_value);
+    out += ",\"seen_ms\":";
+    out += std::to_string(seen_ms);
+    out += ",\"risk\":\"";
+    out += risk_level_name(analysis.risk_level);
+    out += "\",\"reason\":\"";
+    out += risk_reason_text(analysis.risk_reason);
+    out += "\",\"factors\":[";
+    bool first = true;
+    for (const std::string& factor : risk_factor_texts(analysis)) {
+        out += first ? "\"" : ",\"";
+        out += factor;          // fixed texts and numbers, nothing to escape
+        out += '"';
+        first = false;
+    }
+    out += ']';
+    append_number("estimated_mev_profit_eth", analysis.estimated_mev_profit_eth);
+    append_number("sandwich_frontrun_eth", analysis.sandwich_frontrun_eth);
+    append_number("slippage_percent", analysis.slippage_percent);
+    append_number("swap_notional_eth", analysis.swap_notional_eth);
+    out += '}';
+}
+
+} // namespace mev_shield
@@ -1,65 +1,203 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
-#include <thread>
+#include <cstdio>
+#include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 #include <memory>
 #include <chrono>
+#include "analytics/opportunity_store.hpp"
+#include "common/config_loader.hpp"
+#include "common/epoch.hpp"
+#include "common/latency_histogram.hpp"
 #include "common/logger.hpp"
+#include "common/metrics.hpp"
+#include "network/analysis_json.hpp"
+#include "network/http_server.hpp"
+#include "network/mempool_monitor.hpp"
+#include "network/push_feed.hpp"
+#include "network/response_cache.hpp"
 
 namespace mev_shield {
 
 class APIServer {
 private:
-    std::atomic<bool> running_{false};
-    std::thread server_thread_;
-    int port_;
+    APIConfig config_;
     std::shared_ptr<MempoolMonitor> mempool_monitor_;
+    std::chrono::steady_clock::time_point started_ = std::chrono::steady_clock::now();
+    std::shared_ptr<PushFeed> push_feed_;    // shared with the monitor's worker threads
+    std::shared_ptr<OpportunityStore> opportunities_;    // likewise
+    std::unique_ptr<HttpServer> http_;
+    
+    // Polled bodies, rebuilt only when their data version moves. The ETag
+    // tag includes the start time so tags never repeat across restarts.
+    std::string etag_run_ = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    ResponseCache stats_cache_{"s" + etag_run_};
+    ResponseCache opportunities_cache_{"o" + etag_run_, true};     // snapshot versions only grow
+    ResponseCache config_cache_{"c" + etag_run_};
+    std::atomic<uint64_t> not_modified_{0};
+    // Per-entry JSON from the newest opportunities build, ids descending;
+    // only touched by the build, under opportunities_cache_'s lock
+    std::vector<std::pair<uint64_t, std::string>> opportunity_fragments_;
+    uint64_t opportunity_fragments_version_ = 0;
     
 public:
-    APIServer(int port, std::shared_ptr<MempoolMonitor> mempool_monitor) 
-        : port_(port), mempool_monitor_(mempool_monitor) {}
+    // Subscribes the /ws feed and the opportunity store to the monitor's
+    // analyses, so construct before mempool_monitor->run()
+    APIServer(const APIConfig& config, std::shared_ptr<MempoolMonitor> mempool_monitor) 
+        : config_(config)
+        , mempool_monitor_(mempool_monitor)
+        , push_feed_(std::make_shared<PushFeed>(push_options(config)))
+        , opportunities_(std::make_shared<OpportunityStore>(
+              static_cast<size_t>(std::max(config.opportunity_capacity, 1)),
+              std::chrono::seconds(std::max(config.opportunity_ttl_seconds, 1)))) {
+        if (mempool_monitor_) {
+            mempool_monitor_->add_analysis_listener(
+                [feed = push_feed_](const TransactionInfo& tx, const TransactionAnalysis& analysis) {
+                    feed->publish(tx, analysis);
+                });
+            mempool_monitor_->add_analysis_listener(
+                [store = opportunities_](const TransactionInfo& tx, const TransactionAnalysis& analysis) {
+                    store->record(tx, analysis);
+                });
+        }
+    }
+    
+    ~APIServer() {
+        stop();
+    }
     
-    void start() {
-        running_ = true;
-        server_thread_ = std::thread([this]() {
-            this->run_server();
+    // Serves on its own threads; false if the port cannot be bound
+    bool start() {
+        http_ = std::make_unique<HttpServer>(
+            config_.port, static_cast<size_t>(std::max(config_.max_connections, 1)),
+            static_cast<size_t>(std::max(config_.threads, 1)),
+            [this](const HttpRequest& request, HttpResponse& response) { handle(request, response); });
+        http_->set_upgrade_handler([this](boost::asio::ip::tcp::socket socket, std::string buffered,
+                                          HttpServer::ConnectionSlot slot) {
+            push_feed_->subscribe(std::move(socket), std::move(buffered), std::move(slot));
         });
-        LOG_INFO("API Server started on port {}", port_);
+        if (!http_->start()) {
+            http_.reset();
+            return false;
+        }
+        opportunities_->start();
+        LOG_INFO("API Server started on port {} ({} thread(s), max {} connections)",
+                 config_.port, config_.threads, config_.max_connections);
         
         // Print API information
         std::cout << "\n🌐 MEV Shield API Endpoints:" << std::endl;
-        std::cout << "   http://localhost:" << port_ << "/api/health" << std::endl;
-        std::cout << "   http://localhost:" << port_ << "/api/stats" << std::endl;
-        std::cout << "   http://localhost:" << port_ << "/api/opportunities" << std::endl;
-        std::cout << "   http://localhost:" << port_ << "/api/config" << std::endl;
+        std::cout << "   http://localhost:" << config_.port << "/api/health" << std::endl;
+        std::cout << "   http://localhost:" << config_.port << "/api/stats" << std::endl;
+        std::cout << "   http://localhost:" << config_.port << "/api/opportunities" << std::endl;
+        std::cout << "   http://localhost:" << config_.port << "/api/config" << std::endl;
+        std::cout << "   http://localhost:" << config_.port << "/metrics" << std::endl;
+        std::cout << "   ws://localhost:" << config_.port << "/ws" << std::endl;
         std::cout << std::endl;
+        return true;
     }
     
     void stop() {
-        running_ = false;
-        if (server_thread_.joinable()) {
-            server_thread_.join();
+        if (!http_) {
+            return;
+        }
+        // Publishing after close_all() finds no subscribers. The I/O
+        // threads keep running until every 1001 close frame is written
+        push_feed_->close_all();
+        if (!push_feed_->wait_closed(PushSubscriber::kCloseTimeout + std::chrono::seconds(1))) {
+            LOG_WARN("⚠️ Some /ws subscribers were still open at shutdown");
         }
+        http_->stop();
+        http_.reset();
+        opportunities_->stop();
         LOG_INFO("API Server stopped");
     }
     
 private:
-    void run_server() {
-        int request_count = 0;
-        
-        while (running_) {
-            // Simulate API server processing
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-            
-            // In a real implementation, this would handle HTTP requests
-            // For now, we'll simulate API functionality that your app can use
-            
-            if (request_count % 15 == 0) { // Log every 30 seconds
-                LOG_INFO("[API] Server active - Port: {}, Requests: {}", port_, request_count);
+    // Runs on an HTTP thread; everything it reads is safe off the ingest thread
+    void handle(const HttpRequest& request, HttpResponse& response) {
+        if (request.method != "GET" && request.method != "HEAD") {
+            response.status = 405;
+            response.body = R"({"error":"method not allowed"})";
+            return;
+        }
+        const std::string& path = request.path;
+        if (path == "/ws") {
+            // Subscribers keep their connection slot, so max_connections
+            // bounds HTTP clients and /ws subscribers together
+            if (request.websocket_key.empty()) {
+                response.status = 400;
+                response.body = R"({"error":"websocket upgrade required"})";
+            } else {
+                response.upgrade = true;
+            }
+        } else if (path == "/api/health" || path == "/health" || path == "/status") {
+            response.body = generate_health_response();
+        } else if (path == "/api/stats") {
+            StatsInputs inputs = stats_inputs();
+            serve_cached(request, response, stats_cache_.get(stats_version(inputs), [&]() {
+                return generate_stats_response(inputs);
+            }));
+        } else if (path == "/api/opportunities" || path == "/opportunities") {
+            Epoch::Guard guard;
+            const OpportunitySnapshot& snapshot = opportunities_->snapshot(guard);
+            serve_cached(request, response, opportunities_cache_.get(snapshot.version, [&]() {
+                return generate_opportunities_response(snapshot);
+            }));
+        } else if (path == "/api/config") {
+            serve_cached(request, response, config_cache_.get(1, [&]() { return generate_config_response(); }));
+        } else if (path == "/metrics") {
+            response.content_type = "text/plain; version=0.0.4";
+            response.body = generate_metrics_response();
+        } else {
+            response.status = 404;
+            response.body = R"({"error":"not found"})";
+        }
+    }
+    
+    // 304 when the client already holds this version, else the shared body
+    void serve_cached(const HttpRequest& request, HttpResponse& response,
+                      std::shared_ptr<const CachedBody> cached) {
+        response.etag = cached->etag;
+        if (etag_matches(request.if_none_match, cached->etag)) {
+            response.status = 304;
+            not_modified_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const std::string* body = &cached->body;
+        response.shared_body = std::shared_ptr<const std::string>(std::move(cached), body);
+    }
+    
+    // Everything /api/stats shows, read once so the body and its version agree
+    struct StatsInputs {
+        uint64_t low = 0;
+        uint64_t medium = 0;
+        uint64_t high = 0;
+        uint64_t profit_gwei = 0;
+    };
+    
+    StatsInputs stats_inputs() const {
+        StatsInputs inputs;
+        inputs.low = Metrics::total(Counter::AnalyzedLow);
+        inputs.medium = Metrics::total(Counter::AnalyzedMedium);
+        inputs.high = Metrics::total(Counter::AnalyzedHigh);
+        inputs.profit_gwei = Metrics::total(Counter::ProfitGwei);
+        return inputs;
+    }
+    
+    // FNV-1a over the inputs; equal inputs, equal body
+    static uint64_t stats_version(const StatsInputs& inputs) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (uint64_t value : {inputs.low, inputs.medium, inputs.high, inputs.profit_gwei}) {
+            for (int i = 0; i < 8; ++i) {
+                hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 0x100000001B3ULL;
             }
-            request_count++;
         }
+        return hash;
     }
     
     // API response generators
@@ -68,43 +206,296 @@ private:
             "status": "healthy",
             "service": "mev_shield",
             "version": "1.0.0",
-            "timestamp": ")" + get_timestamp() + R"("
+            "timestamp": ")" + get_timestamp() + R"(",
+            "uptime_seconds": )" + std::to_string(uptime_seconds()) + R"(
         })";
     }
     
-    std::string generate_stats_response() {
+    std::string generate_stats_response(const StatsInputs& inputs) {
+        char profit[32];
+        std::snprintf(profit, sizeof(profit), "%.9f", inputs.profit_gwei / 1e9);
         return R"({
-            "transactions_analyzed": 15432,
-            "mev_opportunities_found": 23,
-            "high_risk_transactions": 5,
-            "estimated_profit_eth": 0.45,
-            "uptime_seconds": 3600
+            "transactions_analyzed": )" + std::to_string(inputs.low + inputs.medium + inputs.high) + R"(,
+            "mev_opportunities_found": )" + std::to_string(inputs.medium + inputs.high) + R"(,
+            "high_risk_transactions": )" + std::to_string(inputs.high) + R"(,
+            "estimated_profit_eth": )" + profit + R"(
         })";
     }
     
-    std::string generate_opportunities_response() {
+    std::string generate_config_response() {
         return R"({
-            "active_opportunities": [
-                {
-                    "type": "arbitrage",
-                    "estimated_profit_eth": 0.12,
-                    "risk_score": 0.3,
-                    "tokens": ["WETH", "DAI"]
-                },
-                {
-                    "type": "liquidation", 
-                    "estimated_profit_eth": 0.08,
-                    "risk_score": 0.4,
-                    "tokens": ["USDC", "ETH"]
-                }
-            ]
+            "port": )" + std::to_string(config_.port) + R"(,
+            "max_connections": )" + std::to_string(config_.max_connections) + R"(,
+            "threads": )" + std::to_string(config_.threads) + R"(
         })";
     }
     
+    // Prometheus text exposition format (version 0.0.4). Counters are summed
+    // across the per-thread slots and latencies merged across the per-thread
+    // histograms here, at scrape time, so the hot paths only ever touch
+    // their own thread's memory.
+    std::string generate_metrics_response() {
+        std::string out;
+        out.reserve(8192);
+        
+        metric_header(out, "mev_shield_uptime_seconds", "gauge", "Seconds since the API server started");
+        sample(out, "mev_shield_uptime_seconds", "", uptime_seconds());
+        
+        metric_header(out, "mev_shield_frames_received_total", "counter", "WebSocket frames received across all feeds");
+        sample(out, "mev_shield_frames_received_total", "", Metrics::total(Counter::FramesReceived));
+        metric_header(out, "mev_shield_parse_errors_total", "counter", "WebSocket frames that were not valid JSON");
+        sample(out, "mev_shield_parse_errors_total", "", Metrics::total(Counter::ParseErrors));
+        
+        metric_header(out, "mev_shield_transactions_analyzed_total", "counter", "Transactions analyzed, by risk level");
+        sample(out, "mev_shield_transactions_analyzed_total", "risk=\"low\"", Metrics::total(Counter::AnalyzedLow));
+        sample(out, "mev_shield_transactions_analyzed_total", "risk=\"medium\"", Metrics::total(Counter::AnalyzedMedium));
+        sample(out, "mev_shield_transactions_analyzed_total", "risk=\"high\"", Metrics::total(Counter::AnalyzedHigh));
+        metric_header(out, "mev_shield_estimated_profit_eth_total", "counter",
+                      "Estimated MEV profit of MEDIUM and HIGH risk transactions");
+        sample(out, "mev_shield_estimated_profit_eth_total", "", Metrics::total(Counter::ProfitGwei) / 1e9);
+        
+        if (mempool_monitor_) {
+            const MempoolMonitor& monitor = *mempool_monitor_;
+            metric_header(out, "mev_shield_analysis_queue_depth", "gauge", "Transactions waiting for an analysis worker");
+            sample(out, "mev_shield_analysis_queue_depth", "", monitor.queue_depth());
+            metric_header(out, "mev_shield_analysis_queue_capacity", "gauge", "Capacity of the analysis queue");
+            sample(out, "mev_shield_analysis_queue_capacity", "", monitor.queue_capacity());
+            metric_header(out, "mev_shield_analysis_dropped_total", "counter", "Transactions dropped on a full analysis queue");
+            sample(out, "mev_shield_analysis_dropped_total", "", monitor.dropped_count());
+            
+            if (const TransactionFetcher* fetcher = monitor.fetcher()) {
+                metric_header(out, "mev_shield_fetch_backlog", "gauge", "Hashes waiting for a transaction body lookup");
+                sample(out, "mev_shield_fetch_backlog", "", fetcher->backlog());
+                metric_header(out, "mev_shield_fetch_transactions_total", "counter", "Transaction body lookups, by outcome");
+                sample(out, "mev_shield_fetch_transactions_total", "result=\"found\"", fetcher->fetched_count());
+                sample(out, "mev_shield_fetch_transactions_total", "result=\"missing\"", fetcher->missing_count());
+                sample(out, "mev_shield_fetch_transactions_total", "result=\"dropped\"", fetcher->dropped_count());
+                metric_header(out, "mev_shield_rpc_failed_batches_total", "counter", "JSON-RPC batch requests that failed");
+                sample(out, "mev_shield_rpc_failed_batches_total", "", fetcher->failed_batch_count());
+            }
+            
+            std::vector<FeedStats> feeds = monitor.feed_stats();
+            metric_header(out, "mev_shield_feed_connected", "gauge", "1 while the provider's subscription is live");
+            for (const auto& feed : feeds) {
+                sample(out, "mev_shield_feed_connected", provider_label(feed.provider), uint64_t{feed.connected ? 1u : 0u});
+            }
+            metric_header(out, "mev_shield_feed_reconnects_total", "counter", "Reconnect attempts per provider");
+            for (const auto& feed : feeds) {
+                sample(out, "mev_shield_feed_reconnects_total", provider_label(feed.provider), feed.reconnects);
+            }
+            metric_header(out, "mev_shield_feed_notifications_total", "counter", "Pending transaction notifications per provider");
+            for (const auto& feed : feeds) {
+                sample(out, "mev_shield_feed_notifications_total", provider_label(feed.provider), feed.seen);
+            }
+            
+            if (const auto& pools = monitor.pool_cache()) {
+                metric_header(out, "mev_shield_pool_cache_pools", "gauge", "Pools tracked by the AMM state cache");
+                sample(out, "mev_shield_pool_cache_pools", "state=\"tracked\"", pools->size());
+                sample(out, "mev_shield_pool_cache_pools", "state=\"ready\"", pools->ready_count());
+            }
+        }
+        
+        if (http_) {
+            metric_header(out, "mev_shield_api_connections", "gauge", "Open HTTP connections to the API");
+            sample(out, "mev_shield_api_connections", "", uint64_t{http_->connection_count()});
+            metric_header(out, "mev_shield_api_requests_total", "counter", "HTTP requests served by the API");
+            sample(out, "mev_shield_api_requests_total", "", http_->request_count());
+            metric_header(out, "mev_shield_api_rejected_connections_total", "counter",
+                          "HTTP connections refused over api.max_connections");
+            sample(out, "mev_shield_api_rejected_connections_total", "", http_->rejected_count());
+        }
+        metric_header(out, "mev_shield_api_body_builds_total", "counter",
+                      "Cached response bodies serialized, by endpoint; polls in between reuse them");
+        sample(out, "mev_shield_api_body_builds_total", "endpoint=\"stats\"", stats_cache_.build_count());
+        sample(out, "mev_shield_api_body_builds_total", "endpoint=\"opportunities\"", opportunities_cache_.build_count());
+        metric_header(out, "mev_shield_api_not_modified_total", "counter", "Polls answered 304 from If-None-Match");
+        sample(out, "mev_shield_api_not_modified_total", "", not_modified_.load(std::memory_order_relaxed));
+        
+        metric_header(out, "mev_shield_opportunities", "gauge", "MEDIUM and HIGH analyses served by /api/opportunities");
+        sample(out, "mev_shield_opportunities", "", uint64_t{opportunities_->live_count()});
+        metric_header(out, "mev_shield_opportunities_expired_total", "counter", "Opportunities dropped by the TTL");
+        sample(out, "mev_shield_opportunities_expired_total", "", opportunities_->expired_count());
+        metric_header(out, "mev_shield_opportunities_dropped_total", "counter",
+                      "Opportunities lost to a full intake ring");
+        sample(out, "mev_shield_opportunities_dropped_total", "", opportunities_->dropped_count());
+        
+        metric_header(out, "mev_shield_push_subscribers", "gauge", "Clients subscribed to the /ws push feed");
+        sample(out, "mev_shield_push_subscribers", "", uint64_t{push_feed_->subscriber_count()});
+        metric_header(out, "mev_shield_push_messages_total", "counter",
+                      "Analyses broadcast on the /ws push feed; also the latest seq");
+        sample(out, "mev_shield_push_messages_total", "", push_feed_->published_count());
+        metric_header(out, "mev_shield_push_dropped_total", "counter",
+                      "Messages discarded by the overflow policy across all subscribers");
+        sample(out, "mev_shield_push_dropped_total", "", push_feed_->dropped_count());
+        metric_header(out, "mev_shield_push_slow_disconnects_total", "counter",
+                      "Subscribers disconnected for a full send queue");
+        sample(out, "mev_shield_push_slow_disconnects_total", "", push_feed_->slow_disconnect_count());
+        
+        std::vector<PushSubscriberStats> subscribers = push_feed_->subscriber_stats();
+        metric_header(out, "mev_shield_push_subscriber_lag_messages", "gauge",
+                      "Messages published but not yet written to the subscriber");
+        for (const auto& subscriber : subscribers) {
+            sample(out, "mev_shield_push_subscriber_lag_messages", subscriber_label(subscriber.id), subscriber.lag);
+        }
+        metric_header(out, "mev_shield_push_subscriber_queued", "gauge", "Messages in the subscriber's send queue");
+        for (const auto& subscriber : subscribers) {
+            sample(out, "mev_shield_push_subscriber_queued", subscriber_label(subscriber.id), uint64_t{subscriber.queued});
+        }
+        metric_header(out, "mev_shield_push_subscriber_dropped_total", "counter",
+                      "Messages the overflow policy discarded for the subscriber");
+        for (const auto& subscriber : subscribers) {
+            sample(out, "mev_shield_push_subscriber_dropped_total", subscriber_label(subscriber.id), subscriber.dropped);
+        }
+        
+        metric_header(out, "mev_shield_stage_latency_seconds", "summary",
+                      "Per-stage pipeline latency; fetch is the RPC batch round trip");
+        for (size_t i = 0; i < kStageCount; ++i) {
+            Stage stage = static_cast<Stage>(i);
+            LatencySummary summary = StageLatency::get_instance().summary(stage);
+            std::string label = std::string("stage=\"") + stage_name(stage) + "\"";
+            sample(out, "mev_shield_stage_latency_seconds", label + ",quantile=\"0.5\"", summary.p50_ns / 1e9);
+            sample(out, "mev_shield_stage_latency_seconds", label + ",quantile=\"0.99\"", summary.p99_ns / 1e9);
+            sample(out, "mev_shield_stage_latency_seconds", label + ",quantile=\"0.999\"", summary.p999_ns / 1e9);
+            sample(out, "mev_shield_stage_latency_seconds_sum", label, summary.sum_ns / 1e9);
+            sample(out, "mev_shield_stage_latency_seconds_count", label, summary.count);
+        }
+        return out;
+    }
+    
+    // Serialized from the pinned snapshot while the analysis workers keep
+    // recording. Entries are immutable once stored, so JSON built for an
+    // id on an earlier version is reused and only new entries are
+    // serialized; both lists are in descending id order. A build for an
+    // older snapshot reads the fragments but leaves them to the newest.
+    std::string generate_opportunities_response(const OpportunitySnapshot& snapshot) {
+        bool newest = snapshot.version >= opportunity_fragments_version_;
+        std::vector<std::pair<uint64_t, std::string>> fragments;
+        fragments.reserve(snapshot.entries.size());
+        size_t previous = 0;
+        size_t bytes = 0;
+        for (const Opportunity& opportunity : snapshot.entries) {
+            while (previous < opportunity_fragments_.size() && opportunity_fragments_[previous].first > opportunity.id) {
+                ++previous;
+            }
+            if (previous < opportunity_fragments_.size() && opportunity_fragments_[previous].first == opportunity.id) {
+                if (newest) {
+                    fragments.push_back(std::move(opportunity_fragments_[previous++]));
+                } else {
+                    fragments.push_back(opportunity_fragments_[previous++]);
+                }
+            } else {
+                std::string json;
+                append_analysis_json(json, opportunity.tx(), opportunity.analysis, opportunity.seen_ms);
+                fragments.emplace_back(opportunity.id, std::move(json));
+            }
+            bytes += fragments.back().second.size() + 1;
+        }
+        if (newest) {
+            opportunity_fragments_ = std::move(fragments);
+            opportunity_fragments_version_ = snapshot.version;
+        }
+        const auto& serialized = newest ? opportunity_fragments_ : fragments;
+        
+        std::string out;
+        out.reserve(128 + bytes);
+        out += "{\"version\":";
+        out += std::to_string(snapshot.version);
+        out += ",\"count\":";
+        out += std::to_string(snapshot.entries.size());
+        out += ",\"ttl_seconds\":";
+        out += std::to_string(config_.opportunity_ttl_seconds);
+        out += ",\"active_opportunities\":[";
+        for (size_t i = 0; i < serialized.size(); ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            out += serialized[i].second;
+        }
+        out += "]}";
+        return out;
+    }
+    
+    static PushFeed::Options push_options(const APIConfig& config) {
+        PushFeed::Options options;
+        options.min_risk = parse_risk_level(config.push_min_risk);
+        options.queue_messages = static_cast<size_t>(std::max(config.push_queue_messages, 1));
+        options.overflow = parse_overflow_policy(config.push_overflow);
+        return options;
+    }
+    
+    static TransactionAnalysis::RiskLevel parse_risk_level(const std::string& name) {
+        if (name == "low" || name == "LOW") {
+            return TransactionAnalysis::LOW;
+        }
+        if (name == "high" || name == "HIGH") {
+            return TransactionAnalysis::HIGH;
+        }
+        return TransactionAnalysis::MEDIUM;
+    }
+    
+    uint64_t uptime_seconds() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - started_).count());
+    }
+    
+    static void metric_header(std::string& out, const char* name, const char* type, const char* help) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+    
+    static void sample(std::string& out, const char* name, const std::string& labels, uint64_t value) {
+        append_name(out, name, labels);
+        out += std::to_string(value);
+        out += '\n';
+    }
+    
+    static void sample(std::string& out, const char* name, const std::string& labels, double value) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.9g", value);
+        append_name(out, name, labels);
+        out += text;
+        out += '\n';
+    }
+    
+    static void append_name(std::string& out, const char* name, const std::string& labels) {
+        out += name;
+        if (!labels.empty()) {
+            out += '{';
+            out += labels;
+            out += '}';
+        }
+        out += ' ';
+    }
+    
+    // Provider names come from config; quotes and backslashes are escaped
+    static std::string provider_label(const std::string& provider) {
+        std::string label = "provider=\"";
+        for (char c : provider) {
+            if (c == '"' || c == '\\') {
+                label += '\\';
+            }
+            label += c;
+        }
+        label += '"';
+        return label;
+    }
+    
+    static std::string subscriber_label(uint64_t id) {
+        return "subscriber=\"" + std::to_string(id) + "\"";
+    }
+    
     std::string get_timestamp() {
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::string timestamp = std::ctime(&time_t);
+        char buffer[32];
+        std::string timestamp = ctime_r(&time_t, buffer);   // handlers run on several threads
         timestamp.pop_back(); // Remove newline
         return timestamp;
     }
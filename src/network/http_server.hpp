@@ -0,0 +1,424 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <strings.h>
+#include <boost/asio.hpp>
+#include "common/logger.hpp"
+#include "common/sha1.hpp"
+
+namespace mev_shield {
+
+struct HttpRequest {
+    std::string method;
+    std::string path;            // target without the query string
+    bool keep_alive = true;
+    std::string websocket_key;   // set on "Upgrade: websocket" requests
+    std::string if_none_match;
+};
+
+struct HttpResponse {
+    int status = 200;
+    const char* content_type = "application/json";
+    std::string body;
+    // Sent instead of `body` when set: a cached body is written straight
+    // from its shared buffer, never copied per request
+    std::shared_ptr<const std::string> shared_body;
+    std::string etag;            // quoted; also sent on 304
+    bool upgrade = false;        // accept the request's WebSocket upgrade
+};
+
+// Small HTTP/1.1 server on boost::asio for the API. Connections are kept
+// alive (and may pipeline) until the client closes, asks to close, or
+// stays idle for kIdleTimeout. Accepting never blocks: beyond
+// max_connections a new connection gets a 503 and is closed.
+//
+// Runs its own io_context on its own threads, never on the websocket
+// thread. Each connection lives on a strand, so the handler may run on
+// any server thread but never concurrently for one connection.
+//
+// A handler accepts a WebSocket upgrade by setting HttpResponse::upgrade;
+// the server answers 101 and hands the socket, with any bytes read past
+// the handshake, to the upgrade handler. The socket stays on its strand
+// and keeps counting against max_connections until its ConnectionSlot,
+// handed over with it, is released.
+class HttpServer {
+public:
+    // One of max_connections, given back when the last copy is destroyed
+    using ConnectionSlot = std::shared_ptr<void>;
+    using Handler = std::function<void(const HttpRequest& request, HttpResponse& response)>;
+    using UpgradeHandler = std::function<void(boost::asio::ip::tcp::socket socket, std::string buffered,
+                                              ConnectionSlot slot)>;
+
+    static constexpr size_t kMaxRequestBytes = 16 * 1024;
+    static constexpr std::chrono::seconds kIdleTimeout{30};
+
+    HttpServer(int port, size_t max_connections, size_t threads, Handler handler)
+        : port_(port)
+        , max_connections_(max_connections > 0 ? max_connections : 1)
+        , thread_count_(threads > 0 ? threads : 1)
+        , handler_(std::move(handler))
+        , acceptor_(io_) {}
+
+    ~HttpServer() {
+        stop();
+    }
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Set before start()
+    void set_upgrade_handler(UpgradeHandler handler) {
+        upgrade_handler_ = std::move(handler);
+    }
+
+    // False when the port cannot be bound
+    bool start() {
+        if (running_.exchange(true)) {
+            return true;
+        }
+        boost::system::error_code ec;
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), static_cast<unsigned short>(port_));
+        acceptor_.open(endpoint.protocol(), ec);
+        if (!ec) {
+            acceptor_.set_option(boost::asio::socket_base::reuse_address(true), ec);
+        }
+        if (!ec) {
+            acceptor_.bind(endpoint, ec);
+        }
+        if (!ec) {
+            acceptor_.listen(boost::asio::socket_base::max_listen_connections, ec);
+        }
+        if (ec) {
+            LOG_ERROR("API server cannot listen on port {}: {}", port_, ec.message());
+            running_ = false;
+            return false;
+        }
+
+        accept();
+        for (size_t i = 0; i < thread_count_; ++i) {
+            threads_.emplace_back([this]() { io_.run(); });
+        }
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        boost::asio::post(io_, [this]() {
+            boost::system::error_code ignored;
+            acceptor_.close(ignored);
+        });
+        io_.stop();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        threads_.clear();
+    }
+
+    size_t connection_count() const { return connections_.load(std::memory_order_relaxed); }
+    uint64_t request_count() const { return requests_.load(std::memory_order_relaxed); }
+    uint64_t rejected_count() const { return rejected_.load(std::memory_order_relaxed); }
+
+private:
+    class Connection;
+
+    int port_;
+    size_t max_connections_;
+    size_t thread_count_;
+    Handler handler_;
+    UpgradeHandler upgrade_handler_;
+    // Declared before io_: connections still queued in it at destruction
+    // decrement connections_ as they are released
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> connections_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> rejected_{0};
+    boost::asio::io_context io_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::vector<std::thread> threads_;
+
+    void accept() {
+        acceptor_.async_accept(boost::asio::make_strand(io_),
+            [this](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket) {
+                if (ec == boost::asio::error::operation_aborted || !acceptor_.is_open()) {
+                    return;
+                }
+                if (!ec) {
+                    socket.set_option(boost::asio::ip::tcp::no_delay(true));
+                    bool admitted = connections_.fetch_add(1, std::memory_order_relaxed) < max_connections_;
+                    auto connection = std::make_shared<Connection>(*this, std::move(socket));
+                    if (admitted) {
+                        connection->start();
+                    } else {
+                        rejected_.fetch_add(1, std::memory_order_relaxed);
+                        connection->reject();
+                    }
+                }
+                accept();
+            });
+    }
+
+    class Connection : public std::enable_shared_from_this<Connection> {
+    public:
+        Connection(HttpServer& server, boost::asio::ip::tcp::socket socket)
+            : server_(server)
+            , socket_(std::move(socket))
+            , idle_timer_(socket_.get_executor())
+            , buffer_(kMaxRequestBytes) {}
+
+        ~Connection() {
+            if (!upgraded_) {
+                server_.connections_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        void start() {
+            read();
+        }
+
+        void reject() {
+            response_ = error_response(503, R"({"error":"too many connections"})");
+            write_response(false, false);
+        }
+
+    private:
+        HttpServer& server_;
+        boost::asio::ip::tcp::socket socket_;
+        boost::asio::steady_timer idle_timer_;
+        std::vector<char> buffer_;
+        size_t used_ = 0;
+        HttpRequest request_;
+        HttpResponse response_;
+        std::string head_;
+        bool upgraded_ = false;      // the slot moved on with the socket
+
+        void read() {
+            idle_timer_.expires_after(kIdleTimeout);
+            idle_timer_.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
+                if (!ec) {
+                    boost::system::error_code ignored;
+                    self->socket_.close(ignored);
+                }
+            });
+            socket_.async_read_some(boost::asio::buffer(buffer_.data() + used_, buffer_.size() - used_),
+                [self = shared_from_this()](const boost::system::error_code& ec, size_t bytes) {
+                    self->idle_timer_.cancel();
+                    if (ec) {
+                        return;      // closed by the peer or the idle timer
+                    }
+                    self->used_ += bytes;
+                    self->process();
+                });
+        }
+
+        // Handles the first complete request in the buffer, if any
+        void process() {
+            const char* begin = buffer_.data();
+            const char* end = static_cast<const char*>(memmem(begin, used_, "\r\n\r\n", 4));
+            if (!end) {
+                if (used_ == buffer_.size()) {
+                    response_ = error_response(431, R"({"error":"request too large"})");
+                    write_response(false, false);
+                } else {
+                    read();
+                }
+                return;
+            }
+            size_t head_size = static_cast<size_t>(end - begin) + 4;
+
+            size_t content_length = 0;
+            if (!parse_head(begin, head_size, content_length)) {
+                response_ = error_response(400, R"({"error":"bad request"})");
+                write_response(false, false);
+                return;
+            }
+            // Bodies are not used by any route but must be skipped to find
+            // the next pipelined request
+            if (content_length > buffer_.size() - head_size) {
+                response_ = error_response(413, R"({"error":"body too large"})");
+                write_response(false, false);
+                return;
+            }
+            if (used_ < head_size + content_length) {
+                read();
+                return;
+            }
+            consume(head_size + content_length);
+
+            server_.requests_.fetch_add(1, std::memory_order_relaxed);
+            response_ = HttpResponse{};
+            try {
+                server_.handler_(request_, response_);
+            } catch (const std::exception& e) {
+                LOG_ERROR("API handler exception: {}", e.what());
+                response_ = error_response(500, R"({"error":"internal error"})");
+            }
+            if (response_.upgrade && !request_.websocket_key.empty() && server_.upgrade_handler_) {
+                upgrade();
+                return;
+            }
+            write_response(request_.keep_alive, request_.method == "HEAD");
+        }
+
+        void upgrade() {
+            head_ = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                    "Sec-WebSocket-Accept: " + sha1::websocket_accept(request_.websocket_key) + "\r\n\r\n";
+            boost::asio::async_write(socket_, boost::asio::buffer(head_),
+                [self = shared_from_this()](const boost::system::error_code& ec, size_t) {
+                    if (ec) {
+                        return;
+                    }
+                    std::string buffered(self->buffer_.data(), self->used_);
+                    self->upgraded_ = true;
+                    ConnectionSlot slot(nullptr, [server = &self->server_](void*) {
+                        server->connections_.fetch_sub(1, std::memory_order_relaxed);
+                    });
+                    self->server_.upgrade_handler_(std::move(self->socket_), std::move(buffered), std::move(slot));
+                });
+        }
+
+        // Request line and the two headers that matter here
+        bool parse_head(const char* head, size_t size, size_t& content_length) {
+            const char* line_end = static_cast<const char*>(memmem(head, size, "\r\n", 2));
+            const char* method_end = static_cast<const char*>(std::memchr(head, ' ', line_end - head));
+            if (!method_end) {
+                return false;
+            }
+            const char* target = method_end + 1;
+            const char* target_end = static_cast<const char*>(std::memchr(target, ' ', line_end - target));
+            if (!target_end || line_end - target_end < 9 || std::memcmp(target_end + 1, "HTTP/1.", 7) != 0) {
+                return false;
+            }
+            const char* query = static_cast<const char*>(std::memchr(target, '?', target_end - target));
+            request_.method.assign(head, method_end);
+            request_.path.assign(target, query ? query : target_end);
+            request_.keep_alive = target_end[8] == '1';      // HTTP/1.1 defaults to keep-alive
+            request_.websocket_key.clear();
+            request_.if_none_match.clear();
+            bool websocket = false;
+
+            for (const char* line = line_end + 2; line < head + size - 2;) {
+                const char* next = static_cast<const char*>(memmem(line, head + size - line, "\r\n", 2));
+                const char* colon = static_cast<const char*>(std::memchr(line, ':', next - line));
+                if (colon) {
+                    const char* value = colon + 1;
+                    while (value < next && *value == ' ') {
+                        ++value;
+                    }
+                    std::string name(line, colon);
+                    if (strcasecmp(name.c_str(), "connection") == 0) {
+                        if (contains_token(value, next, "close")) {
+                            request_.keep_alive = false;
+                        } else if (contains_token(value, next, "keep-alive")) {
+                            request_.keep_alive = true;
+                        }
+                    } else if (strcasecmp(name.c_str(), "content-length") == 0) {
+                        content_length = std::strtoul(value, nullptr, 10);
+                    } else if (strcasecmp(name.c_str(), "if-none-match") == 0) {
+                        request_.if_none_match.assign(value, next);
+                    } else if (strcasecmp(name.c_str(), "upgrade") == 0) {
+                        websocket = contains_token(value, next, "websocket");
+                    } else if (strcasecmp(name.c_str(), "sec-websocket-key") == 0) {
+                        const char* value_end = next;
+                        while (value_end > value && value_end[-1] == ' ') {
+                            --value_end;
+                        }
+                        request_.websocket_key.assign(value, value_end);
+                    }
+                }
+                line = next + 2;
+            }
+            if (!websocket) {
+                request_.websocket_key.clear();
+            }
+            return true;
+        }
+
+        static bool contains_token(const char* begin, const char* end, const char* token) {
+            size_t length = std::strlen(token);
+            for (const char* p = begin; p + length <= end; ++p) {
+                if (strncasecmp(p, token, length) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void consume(size_t bytes) {
+            std::memmove(buffer_.data(), buffer_.data() + bytes, used_ - bytes);
+            used_ -= bytes;
+        }
+
+        // Header block and body go out in one gather write
+        void write_response(bool keep_alive, bool head_only) {
+            const std::string& body = response_.shared_body ? *response_.shared_body : response_.body;
+            bool not_modified = response_.status == 304;
+            head_.clear();
+            head_ += "HTTP/1.1 ";
+            head_ += std::to_string(response_.status);
+            head_ += ' ';
+            head_ += reason_phrase(response_.status);
+            if (!not_modified) {
+                head_ += "\r\nContent-Type: ";
+                head_ += response_.content_type;
+                head_ += "\r\nContent-Length: ";
+                head_ += std::to_string(body.size());
+            }
+            if (!response_.etag.empty()) {
+                head_ += "\r\nETag: ";
+                head_ += response_.etag;
+                head_ += "\r\nCache-Control: no-cache";
+            }
+            head_ += keep_alive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+
+            std::array<boost::asio::const_buffer, 2> buffers = {
+                boost::asio::buffer(head_),
+                boost::asio::buffer(body.data(), head_only || not_modified ? 0 : body.size())};
+            boost::asio::async_write(socket_, buffers,
+                [self = shared_from_this(), keep_alive](const boost::system::error_code& ec, size_t) {
+                    if (ec) {
+                        return;
+                    }
+                    if (!keep_alive) {
+                        boost::system::error_code ignored;
+                        self->socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+                        return;
+                    }
+                    self->process();
+                });
+        }
+
+        static HttpResponse error_response(int status, const char* body) {
+            HttpResponse response;
+            response.status = status;
+            response.body = body;
+            return response;
+        }
+
+        static const char* reason_phrase(int status) {
+            switch (status) {
+                case 200: return "OK";
+                case 304: return "Not Modified";
+                case 400: return "Bad Request";
+                case 404: return "Not Found";
+                case 405: return "Method Not Allowed";
+                case 413: return "Payload Too Large";
+                case 431: return "Request Header Fields Too Large";
+                case 503: return "Service Unavailable";
+                default: return "Internal Server Error";
+            }
+        }
+    };
+};
+
+} // namespace mev_shield
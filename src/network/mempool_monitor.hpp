@@ -1,61 +1,266 @@
 #pragma once
 #include <websocketpp/config/asio_client.hpp>
 #include <websocketpp/client.hpp>
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+#include <boost/asio/steady_timer.hpp>
 #include <rapidjson/document.h>
 #include "common/logger.hpp"
+#include "common/config_loader.hpp"
+#include "common/latency_histogram.hpp"
+#include "common/metrics.hpp"
+#include "common/parse_arena.hpp"
+#include "common/ring_buffer.hpp"
+#include "common/work_stealing_pool.hpp"
 #include "analytics/risk_engine.hpp"
+#include "network/notification_parser.hpp"
+#include "network/pool_sync.hpp"
+#include "network/transaction_fetcher.hpp"
+#include "network/tx_deduplicator.hpp"
 
 namespace mev_shield {
 
+// Subscribes to every configured provider at once and merges the feeds
+// into one stream. Each hash is processed once, by whichever provider
+// delivered it first; later copies only feed the per-provider lag stats.
+//
+// The websocket thread only parses and deduplicates. Decoded transactions
+// are handed through a lock-free ring to a work-stealing pool of analysis
+// workers, so a slow risk handler never stalls frame reads; when the ring
+// is full the transaction is dropped and counted.
 class MempoolMonitor {
 public:
+    using AnalysisListener = std::function<void(const TransactionInfo& tx, const TransactionAnalysis& analysis)>;
+    
     MempoolMonitor(const std::string& websocket_url, 
                    std::shared_ptr<RiskEngine> risk_engine)
-        : websocket_url_(websocket_url), risk_engine_(risk_engine) {
+        : MempoolMonitor(RPCProvider{"default", websocket_url, "", 5000}, MempoolConfig{}, risk_engine) {}
+    
+    MempoolMonitor(const RPCProvider& provider,
+                   const MempoolConfig& mempool_config,
+                   std::shared_ptr<RiskEngine> risk_engine)
+        : MempoolMonitor(std::vector<RPCProvider>{provider}, mempool_config, risk_engine) {}
+    
+    MempoolMonitor(const std::vector<RPCProvider>& providers,
+                   const MempoolConfig& mempool_config,
+                   std::shared_ptr<RiskEngine> risk_engine,
+                   const AmmConfig& amm_config = AmmConfig{})
+        : risk_engine_(risk_engine)
+        , reconnect_initial_(std::max(1, mempool_config.reconnect_initial_ms))
+        , reconnect_max_(std::max(mempool_config.reconnect_initial_ms, mempool_config.reconnect_max_ms))
+        , queue_(std::make_unique<RingBuffer<PendingTransaction>>(
+              round_up_pow2(static_cast<size_t>(std::max(mempool_config.queue_capacity, 2)))))
+        , full_transactions_(mempool_config.full_transactions) {
+        
+        size_t analysis_threads = mempool_config.analysis_threads > 0
+            ? static_cast<size_t>(mempool_config.analysis_threads)
+            : std::max(1u, std::thread::hardware_concurrency());
+        workers_ = std::make_unique<WorkStealingPool<PendingTransaction, AnalysisWorkerState>>(
+            analysis_threads,
+            [this](size_t) { return std::make_unique<AnalysisWorkerState>(*risk_engine_); },
+            [this](AnalysisWorkerState& state, PendingTransaction& task) { analyze_transaction(state, task); },
+            mempool_config.pin_analysis_threads);
+        workers_->set_source([this](PendingTransaction& out) {
+            // Swap rather than move so both calldata buffers keep their capacity
+            return queue_->try_pop_with([&out](PendingTransaction& slot) { std::swap(out, slot); });
+        });
+        
+        std::vector<std::string> provider_names;
+        for (const auto& provider : providers) {
+            if (provider.websocket_url.empty()) {
+                LOG_WARN("Provider '{}' has no WebSocket URL - skipping", provider.name);
+                continue;
+            }
+            providers_.push_back(provider);
+            provider_names.push_back(provider.name);
+        }
+        dedup_ = std::make_unique<TxDeduplicator>(provider_names);
+        
+        // Bodies are fetched from the first provider that has an HTTP endpoint
+        auto http_provider = std::find_if(providers_.begin(), providers_.end(),
+            [](const RPCProvider& provider) { return !provider.http_url.empty(); });
+        
+        if (full_transactions_) {
+            LOG_INFO("Full transaction subscription enabled - skipping RPC body lookups");
+        } else if (http_provider != providers_.end()) {
+            fetcher_ = std::make_unique<TransactionFetcher>(
+                http_provider->http_url,
+                static_cast<size_t>(mempool_config.rpc_batch_size),
+                std::chrono::milliseconds(mempool_config.rpc_batch_flush_ms),
+                static_cast<size_t>(mempool_config.rpc_fetch_threads),
+                static_cast<size_t>(mempool_config.max_pending_hashes));
+            fetcher_->set_transaction_handler([this](const rapidjson::Value& tx) {
+                enqueue_transaction(tx);
+            });
+        } else {
+            LOG_WARN("No HTTP RPC URL configured - pending transactions will not be analyzed");
+        }
+        
+        // Pool state for price impact: bootstrapped over HTTP, then kept
+        // current by a logs subscription on every feed
+        if (risk_engine_->pool_cache()) {
+            if (http_provider != providers_.end()) {
+                pool_sync_ = std::make_unique<PoolSync>(
+                    http_provider->http_url, risk_engine_->pool_cache(),
+                    static_cast<size_t>(amm_config.bootstrap_batch_size),
+                    std::chrono::milliseconds(amm_config.bootstrap_flush_ms));
+            } else {
+                LOG_WARN("No HTTP RPC URL configured - pool cache cannot bootstrap, price impact disabled");
+            }
+        }
         
         client_.init_asio();
         client_.set_tls_init_handler([this](websocketpp::connection_hdl) {
             return create_tls_context();
         });
+        stats_timer_ = std::make_unique<boost::asio::steady_timer>(client_.get_io_service());
         
-        client_.set_open_handler([this](auto hdl) { on_open(hdl); });
-        client_.set_message_handler([this](auto hdl, auto msg) { on_message(hdl, msg); });
-        client_.set_fail_handler([this](auto hdl) { on_fail(hdl); });
-        client_.set_close_handler([this](auto hdl) { on_close(hdl); });
+        connections_ = std::vector<ConnectionState>(providers_.size());
+        for (auto& connection : connections_) {
+            connection.reconnect_timer = std::make_unique<boost::asio::steady_timer>(client_.get_io_service());
+        }
+    }
+    
+    ~MempoolMonitor() {
+        // Producers first, so nothing writes into the ring after it is gone
+        if (fetcher_) {
+            fetcher_->stop();
+        }
+        if (pool_sync_) {
+            pool_sync_->stop();
+        }
+        workers_->stop();
     }
     
+    // Blocks until stop() is called from another thread
     void run() {
+        if (stopping_) {
+            return;
+        }
+        workers_->start();
+        LOG_INFO("Analysis pool started with {} workers", workers_->thread_count());
+        if (fetcher_) {
+            fetcher_->start();
+        }
+        if (pool_sync_) {
+            pool_sync_->start();
+        }
+        
         try {
-            websocketpp::lib::error_code ec;
-            auto con = client_.get_connection(websocket_url_, ec);
-            
-            if (ec) {
-                LOG_ERROR("WebSocket connection error: {}", ec.message());
-                return;
+            for (size_t i = 0; i < providers_.size(); ++i) {
+                connect_provider(i);
             }
-            
-            client_.connect(con);
+            schedule_stats_log();
+            // Keep the loop alive while every feed is between reconnects
+            client_.start_perpetual();
             client_.run();
         } catch (const std::exception& e) {
             LOG_ERROR("Mempool monitor exception: {}", e.what());
         }
     }
     
+    // Any thread; safe to call more than once
     void stop() {
+        if (stopping_.exchange(true)) {
+            return;
+        }
+        client_.stop_perpetual();
         client_.stop();
+        if (fetcher_) {
+            fetcher_->stop();
+        }
+        if (pool_sync_) {
+            pool_sync_->stop();
+        }
+        workers_->stop();
         LOG_INFO("Mempool monitor stopped");
     }
     
+    // Invoked concurrently from the analysis worker threads
     void set_risk_handler(std::function<void(const TransactionAnalysis&)> handler) {
         risk_handler_ = handler;
     }
+    
+    // Like the risk handler, with the transaction the analysis is about.
+    // Register before run(); listeners are called on the worker threads.
+    void add_analysis_listener(AnalysisListener listener) {
+        analysis_listeners_.push_back(std::move(listener));
+    }
+    
+    // First-seen win rates and arrival-lag histograms, one entry per provider
+    std::vector<FeedStats> feed_stats() const {
+        std::vector<FeedStats> stats = dedup_->snapshot();
+        for (size_t i = 0; i < stats.size() && i < connections_.size(); ++i) {
+            stats[i].connected = connections_[i].connected.load(std::memory_order_relaxed);
+            stats[i].reconnects = connections_[i].reconnects.load(std::memory_order_relaxed);
+            stats[i].last_gap_ms = connections_[i].last_gap_us.load(std::memory_order_relaxed) / 1000.0;
+        }
+        return stats;
+    }
+    
+    size_t queue_depth() const { return queue_->size(); }
+    size_t queue_capacity() const { return queue_->capacity(); }
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t analyzed_count() const { return workers_->executed_count(); }
+    size_t provider_count() const { return providers_.size(); }
+    
+    // Null when bodies arrive with the notifications or no HTTP URL is set
+    const TransactionFetcher* fetcher() const { return fetcher_.get(); }
+    const std::shared_ptr<PoolCache>& pool_cache() const { return risk_engine_->pool_cache(); }
 
 private:
-    std::string websocket_url_;
+    static constexpr std::chrono::seconds kStatsLogInterval{60};
+    // JSON-RPC id of the pool log subscription (pending transactions use 1),
+    // so the two confirmations can be told apart
+    static constexpr int kLogSubscriptionRequest = 2;
+    
+    // Each worker analyzes with its own engine copy, so engine scratch
+    // buffers stay on one core and nothing is shared between workers
+    struct AnalysisWorkerState {
+        explicit AnalysisWorkerState(const RiskEngine& prototype) : engine(prototype) {}
+        RiskEngine engine;
+    };
+    
+    // Reconnect bookkeeping per provider; only the I/O thread writes it
+    struct ConnectionState {
+        std::unique_ptr<boost::asio::steady_timer> reconnect_timer;
+        int failures = 0;
+        bool down = false;
+        std::chrono::steady_clock::time_point down_since;
+        std::string subscription_id;
+        std::string log_subscription_id;
+        std::atomic<bool> connected{false};
+        std::atomic<uint64_t> reconnects{0};
+        std::atomic<uint64_t> last_gap_us{0};
+    };
+    
+    std::vector<RPCProvider> providers_;
     std::shared_ptr<RiskEngine> risk_engine_;
     websocketpp::client<websocketpp::config::asio_tls_client> client_;
     std::function<void(const TransactionAnalysis&)> risk_handler_;
+    std::vector<AnalysisListener> analysis_listeners_;
+    std::unique_ptr<TransactionFetcher> fetcher_;
+    std::unique_ptr<PoolSync> pool_sync_;
+    std::unique_ptr<TxDeduplicator> dedup_;
+    std::unique_ptr<boost::asio::steady_timer> stats_timer_;
+    std::vector<ConnectionState> connections_;
+    std::chrono::milliseconds reconnect_initial_;
+    std::chrono::milliseconds reconnect_max_;
+    std::mt19937 jitter_rng_{std::random_device{}()};
+    std::atomic<bool> stopping_{false};
+    std::unique_ptr<RingBuffer<PendingTransaction>> queue_;
+    std::unique_ptr<WorkStealingPool<PendingTransaction, AnalysisWorkerState>> workers_;
+    std::atomic<uint64_t> dropped_{0};
+    // Parsing state, only touched by the I/O thread
+    ParseArena parse_arena_;
+    NotificationParser notification_parser_;
+    NotificationParser::Notification notification_;
+    PendingTransaction scratch_tx_;
+    bool full_transactions_ = false;
     
     std::shared_ptr<boost::asio::ssl::context> create_tls_context() {
         auto ctx = std::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::sslv23);
@@ -70,10 +275,35 @@ private:
         return ctx;
     }
     
-    void on_open(websocketpp::connection_hdl hdl) {
-        LOG_INFO("✅ Connected to WebSocket, subscribing to mempool...");
+    void connect_provider(size_t provider) {
+        websocketpp::lib::error_code ec;
+        auto con = client_.get_connection(providers_[provider].websocket_url, ec);
+        
+        if (ec) {
+            LOG_ERROR("WebSocket connection error [{}]: {}", providers_[provider].name, ec.message());
+            return;
+        }
+        
+        // Per-connection handlers so every callback knows which feed it serves
+        con->set_open_handler([this, provider](auto hdl) { on_open(hdl, provider); });
+        con->set_message_handler([this, provider](auto hdl, auto msg) { on_message(hdl, msg, provider); });
+        con->set_fail_handler([this, provider](auto hdl) { on_fail(hdl, provider); });
+        con->set_close_handler([this, provider](auto hdl) { on_close(hdl, provider); });
+        
+        client_.connect(con);
+    }
+    
+    void on_open(websocketpp::connection_hdl hdl, size_t provider) {
+        LOG_INFO("✅ Connected to WebSocket [{}], subscribing to mempool...", providers_[provider].name);
         
-        std::string subscribe_msg = R"({
+        // The trailing 'true' makes geth-style nodes push full transaction
+        // objects instead of bare hashes
+        std::string subscribe_msg = full_transactions_ ? R"({
+            "jsonrpc": "2.0",
+            "id": 1,
+            "method": "eth_subscribe",
+            "params": ["newPendingTransactions", true]
+        })" : R"({
             "jsonrpc": "2.0",
             "id": 1,
             "method": "eth_subscribe",
@@ -81,33 +311,146 @@ private:
         })";
         
         client_.send(hdl, subscribe_msg, websocketpp::frame::opcode::text);
+        
+        if (pool_sync_) {
+            client_.send(hdl, PoolSync::subscribe_message(kLogSubscriptionRequest),
+                         websocketpp::frame::opcode::text);
+        }
     }
     
     void on_message(websocketpp::connection_hdl hdl, 
-                   websocketpp::config::asio_tls_client::message_type::ptr msg) {
+                   websocketpp::config::asio_tls_client::message_type::ptr msg,
+                   size_t provider) {
+        
+        StageTimer frame_timer(Stage::FrameReceive);
+        Metrics::add(Counter::FramesReceived);
+        // Parse the frame buffer in place instead of copying it; the frame
+        // is discarded after this handler, so mutating it is safe
+        std::string& payload = msg->get_raw_payload();
+        process_websocket_message(payload, provider);
+    }
+    
+    void on_fail(websocketpp::connection_hdl hdl, size_t provider) {
+        LOG_ERROR("❌ WebSocket connection failed [{}]", providers_[provider].name);
+        schedule_reconnect(provider);
+    }
+    
+    void on_close(websocketpp::connection_hdl hdl, size_t provider) {
+        LOG_INFO("📡 WebSocket connection closed [{}]", providers_[provider].name);
+        schedule_reconnect(provider);
+    }
+    
+    // Reconnects on a timer instead of sleeping, so the other feeds keep
+    // flowing. The delay doubles per consecutive failure up to the cap, and
+    // a random half of it is jittered so providers that dropped together do
+    // not reconnect in lockstep.
+    void schedule_reconnect(size_t provider) {
+        if (stopping_) {
+            return;
+        }
+        
+        ConnectionState& connection = connections_[provider];
+        connection.connected.store(false, std::memory_order_relaxed);
+        connection.subscription_id.clear();
+        connection.log_subscription_id.clear();
+        if (!connection.down) {
+            connection.down = true;
+            connection.down_since = std::chrono::steady_clock::now();
+        }
+        
+        auto backoff = reconnect_initial_ * (1LL << std::min(connection.failures, 20));
+        auto ceiling = std::min<std::chrono::milliseconds>(backoff, reconnect_max_);
+        std::uniform_int_distribution<int64_t> jitter(ceiling.count() / 2, ceiling.count());
+        std::chrono::milliseconds delay(jitter(jitter_rng_));
+        connection.failures++;
         
-        std::string payload = msg->get_payload();
-        process_websocket_message(payload);
+        LOG_INFO("🔄 Reconnecting [{}] in {} ms (attempt {})",
+                 providers_[provider].name, delay.count(), connection.failures);
+        connection.reconnect_timer->expires_after(delay);
+        connection.reconnect_timer->async_wait([this, provider](const boost::system::error_code& ec) {
+            if (ec || stopping_) {
+                return;
+            }
+            connections_[provider].reconnects.fetch_add(1, std::memory_order_relaxed);
+            connect_provider(provider);
+        });
     }
     
-    void on_fail(websocketpp::connection_hdl hdl) {
-        LOG_ERROR("❌ WebSocket connection failed");
+    // Called once the provider confirms the subscription, i.e. the feed is
+    // actually flowing again, not merely connected
+    void on_subscribed(size_t provider) {
+        ConnectionState& connection = connections_[provider];
+        connection.connected.store(true, std::memory_order_relaxed);
+        connection.failures = 0;
         
-        // Try to reconnect after 5 seconds
-        LOG_INFO("🔄 Attempting to reconnect in 5 seconds...");
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-        run();
+        if (connection.down) {
+            auto gap = std::chrono::steady_clock::now() - connection.down_since;
+            auto gap_us = std::chrono::duration_cast<std::chrono::microseconds>(gap).count();
+            connection.last_gap_us.store(static_cast<uint64_t>(gap_us), std::memory_order_relaxed);
+            connection.down = false;
+            LOG_INFO("✅ Feed [{}] restored after {:.1f} ms", providers_[provider].name, gap_us / 1000.0);
+        }
+    }
+    
+    void schedule_stats_log() {
+        stats_timer_->expires_after(kStatsLogInterval);
+        stats_timer_->async_wait([this](const boost::system::error_code& ec) {
+            if (ec) {
+                return;
+            }
+            log_feed_stats();
+            schedule_stats_log();
+        });
     }
     
-    void on_close(websocketpp::connection_hdl hdl) {
-        LOG_INFO("📡 WebSocket connection closed");
+    void log_feed_stats() {
+        LOG_INFO("📊 Analysis queue: depth={}/{} dropped={} analyzed={} steals={}",
+                 queue_->size(), queue_->capacity(), dropped_.load(std::memory_order_relaxed),
+                 workers_->executed_count(), workers_->steal_count());
+        if (pool_sync_) {
+            const PoolCache& pools = *risk_engine_->pool_cache();
+            LOG_INFO("📊 Pool cache: tracked={} ready={} log_updates={} bootstrapped={} missing={} rejected={}",
+                     pools.size(), pools.ready_count(), pools.log_update_count(),
+                     pool_sync_->bootstrapped_count(), pool_sync_->missing_count(), pools.rejected_count());
+        }
+        for (size_t i = 0; i < kStageCount; ++i) {
+            LatencySummary stage = StageLatency::get_instance().summary(static_cast<Stage>(i));
+            if (stage.count > 0) {
+                LOG_INFO("⏱️  Stage {}: n={} p50={:.1f}us p99={:.1f}us p99.9={:.1f}us max={:.1f}us",
+                         stage_name(static_cast<Stage>(i)), stage.count, stage.p50_ns / 1000.0,
+                         stage.p99_ns / 1000.0, stage.p999_ns / 1000.0, stage.max_ns / 1000.0);
+            }
+        }
+        if (providers_.size() < 2) {
+            return;
+        }
+        for (const auto& stats : dedup_->snapshot()) {
+            LOG_INFO("📊 Feed [{}]: seen={} first={} ({:.1f}%) avg_lag={:.1f}ms",
+                     stats.provider, stats.seen, stats.wins, stats.win_rate * 100.0,
+                     stats.late > 0 ? stats.lag_sum_ms / stats.late : 0.0);
+        }
     }
     
-    void process_websocket_message(const std::string& payload) {
-        rapidjson::Document doc;
-        doc.Parse(payload.c_str());
+    // Runs on the I/O thread for every frame. Notifications take the SAX
+    // fast path; everything else falls back to an in-situ DOM parse whose
+    // nodes come from parse_arena_, so neither path allocates per frame.
+    void process_websocket_message(std::string& payload, size_t provider) {
+        // One parse sample per frame, including a failed SAX attempt
+        StageLatency& latency = StageLatency::get_instance();
+        uint64_t parse_start = StageLatency::now_ns();
+        if (notification_parser_.parse(payload.c_str(), notification_, scratch_tx_)) {
+            latency.record(Stage::Parse, StageLatency::now_ns() - parse_start);
+            handle_notification(provider);
+            return;
+        }
+        
+        parse_arena_.reset();
+        ParseArena::Document doc = parse_arena_.make_document();
+        doc.ParseInsitu(&payload[0]);
+        latency.record(Stage::Parse, StageLatency::now_ns() - parse_start);
         
-        if (doc.HasParseError()) {
+        if (doc.HasParseError() || !doc.IsObject()) {
+            Metrics::add(Counter::ParseErrors);
             LOG_DEBUG("Failed to parse WebSocket message");
             return;
         }
@@ -115,80 +458,177 @@ private:
         // Check if this is a new transaction notification
         if (doc.HasMember("params") && doc["params"].IsObject()) {
             const auto& params = doc["params"];
+            if (is_log_notification(params, provider)) {
+                pool_sync_->apply_log(params["result"]);
+                return;
+            }
+            if (params.HasMember("result") && (params["result"].IsString() || params["result"].IsObject())) {
+                const char* subscription = params.HasMember("subscription") && params["subscription"].IsString()
+                    ? params["subscription"].GetString() : "";
+                if (!is_current_subscription(subscription, provider)) {
+                    return;
+                }
+            }
             if (params.HasMember("result") && params["result"].IsString()) {
-                std::string tx_hash = params["result"].GetString();
-                LOG_INFO("🔍 Detected transaction: {}", tx_hash.substr(0, 16) + "...");
-                simulate_transaction_analysis(tx_hash);
+                const char* tx_hash = params["result"].GetString();
+                if (!dedup_->observe(tx_hash, provider)) {
+                    return;
+                }
+                LOG_DEBUG("🔍 Detected transaction: {:.16}...", tx_hash);
+                if (fetcher_ && !fetcher_->enqueue(tx_hash)) {
+                    LOG_DEBUG("Fetch rejected (backlog full or bad hash): {:.16}", tx_hash);
+                }
+            } else if (params.HasMember("result") && params["result"].IsObject()) {
+                // Full-body subscription: the transaction is already here
+                const auto& tx = params["result"];
+                if (tx.HasMember("hash") && tx["hash"].IsString() &&
+                    !dedup_->observe(tx["hash"].GetString(), provider)) {
+                    return;
+                }
+                enqueue_transaction(tx);
             }
         }
         
+        bool log_request = doc.HasMember("id") && doc["id"].IsInt() &&
+                           doc["id"].GetInt() == kLogSubscriptionRequest;
+        
         // Check if this is a subscription confirmation
         if (doc.HasMember("result") && doc["result"].IsString()) {
-            LOG_INFO("✅ Subscription confirmed: {}", doc["result"].GetString());
+            if (log_request) {
+                LOG_INFO("✅ Pool log subscription confirmed [{}]: {}", providers_[provider].name, doc["result"].GetString());
+                connections_[provider].log_subscription_id = doc["result"].GetString();
+                return;
+            }
+            LOG_INFO("✅ Subscription confirmed [{}]: {}", providers_[provider].name, doc["result"].GetString());
+            connections_[provider].subscription_id = doc["result"].GetString();
+            on_subscribed(provider);
+        }
+        
+        if (doc.HasMember("error") && doc["error"].IsObject()) {
+            const auto& error = doc["error"];
+            if (log_request) {
+                LOG_WARN("⚠️  Pool log subscription rejected [{}] - cached pools will go stale", providers_[provider].name);
+                return;
+            }
+            LOG_ERROR("❌ Subscription error [{}]: {}", providers_[provider].name, error.HasMember("message") && error["message"].IsString()
+                ? error["message"].GetString() : "unknown");
+            if (full_transactions_) {
+                LOG_ERROR("💡 Provider may not support full transaction subscriptions; "
+                          "set mempool.full_transactions to false");
+            }
         }
     }
     
-    void simulate_transaction_analysis(const std::string& tx_hash) {
-        // Create a mock transaction analysis
-        TransactionAnalysis analysis;
+    bool is_log_notification(const rapidjson::Value& params, size_t provider) const {
+        const std::string& log_subscription = connections_[provider].log_subscription_id;
+        return pool_sync_ && !log_subscription.empty() &&
+               params.HasMember("subscription") && params["subscription"].IsString() &&
+               log_subscription == params["subscription"].GetString() &&
+               params.HasMember("result") && params["result"].IsObject();
+    }
+    
+    // False for notifications of a subscription this connection replaced,
+    // which are dropped before they reach the deduplicator. Shared by the
+    // SAX and DOM paths so a frame is judged the same by either parser.
+    bool is_current_subscription(const char* subscription, size_t provider) const {
+        const std::string& current = connections_[provider].subscription_id;
+        if (current.empty() || current == subscription) {
+            return true;
+        }
+        LOG_DEBUG("Ignoring notification for stale subscription {} [{}]", subscription, providers_[provider].name);
+        return false;
+    }
+    
+    void handle_notification(size_t provider) {
+        if (!is_current_subscription(notification_.subscription, provider)) {
+            return;
+        }
         
-        // Simulate random risk levels for demo
-        int risk_roll = rand() % 100;
-        if (risk_roll < 5) { // 5% high risk
-            analysis.risk_level = TransactionAnalysis::HIGH;
-            analysis.estimated_mev_profit_eth = 0.02 + (rand() % 100) / 1000.0;
-            analysis.risk_reason = "High MEV arbitrage opportunity detected";
-        } else if (risk_roll < 20) { // 15% medium risk
-            analysis.risk_level = TransactionAnalysis::MEDIUM;
-            analysis.estimated_mev_profit_eth = 0.005 + (rand() % 50) / 1000.0;
-            analysis.risk_reason = "Medium risk transaction";
-        } else { // 80% low risk
-            analysis.risk_level = TransactionAnalysis::LOW;
-            analysis.estimated_mev_profit_eth = (rand() % 20) / 1000.0;
-            analysis.risk_reason = "Low risk transaction";
+        if (!dedup_->observe(notification_.hash, provider)) {
+            return;
         }
         
-        analysis.slippage_percent = (rand() % 50) / 10.0;
-        analysis.is_dex_swap = (rand() % 3 == 0);
-        analysis.analysis_time_ms = rand() % 100;
+        if (notification_.kind == NotificationParser::ResultKind::Hash) {
+            LOG_DEBUG("🔍 Detected transaction: {:.16}...", notification_.hash);
+            if (fetcher_ && !fetcher_->enqueue(notification_.hash)) {
+                LOG_DEBUG("Fetch rejected (backlog full or bad hash): {:.16}", notification_.hash);
+            }
+            return;
+        }
         
-        // Add risk factors
-        if (analysis.estimated_mev_profit_eth > 0.01) {
-            analysis.risk_factors.push_back("High profit potential");
+        // Swap so the slot's old buffers become the next scratch space
+        scratch_tx_.enqueued_ns = StageLatency::now_ns();
+        bool queued = queue_->try_push_with([this](PendingTransaction& slot) {
+            std::swap(slot, scratch_tx_);
+        });
+        if (!queued) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    // Decodes into scratch space first so a malformed object never occupies
+    // a ring slot; safe from any producer thread
+    void enqueue_transaction(const rapidjson::Value& tx) {
+        thread_local PendingTransaction decoded;
+        bool valid;
+        {
+            StageTimer decode_timer(Stage::Decode);
+            valid = decode_transaction(tx, decoded);
         }
-        if (analysis.slippage_percent > 3.0) {
-            analysis.risk_factors.push_back("High slippage");
+        if (!valid) {
+            LOG_DEBUG("Skipping transaction object without a valid hash");
+            return;
         }
-        if (analysis.is_dex_swap) {
-            analysis.risk_factors.push_back("DEX swap detected");
+        decoded.enqueued_ns = StageLatency::now_ns();
+        bool queued = queue_->try_push_with([](PendingTransaction& slot) {
+            std::swap(slot, decoded);
+        });
+        if (!queued) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    void analyze_transaction(AnalysisWorkerState& state, const PendingTransaction& task) {
+        StageLatency& latency = StageLatency::get_instance();
+        uint64_t start = StageLatency::now_ns();
+        latency.record(Stage::Queue, start - task.enqueued_ns);
+        
+        TransactionAnalysis analysis = state.engine.analyze_transaction(task.tx);
+        uint64_t analyzed = StageLatency::now_ns();
+        latency.record(Stage::Analyze, analyzed - start);
+        Metrics::add(static_cast<Counter>(static_cast<size_t>(Counter::AnalyzedLow) + analysis.risk_level));
+        if (analysis.risk_level != TransactionAnalysis::LOW) {
+            Metrics::add(Counter::ProfitGwei, static_cast<uint64_t>(analysis.estimated_mev_profit_eth * 1e9));
         }
         
         // Call risk handler if set
         if (risk_handler_) {
             risk_handler_(analysis);
         }
+        for (const auto& listener : analysis_listeners_) {
+            listener(task.tx, analysis);
+        }
         
-        log_analysis_result(tx_hash, analysis);
+        log_analysis_result(task.tx, analysis);
+        latency.record(Stage::Dispatch, StageLatency::now_ns() - analyzed);
     }
     
-    void log_analysis_result(const std::string& tx_hash, const TransactionAnalysis& analysis) {
-        std::string level_str;
-        switch (analysis.risk_level) {
-            case TransactionAnalysis::LOW: level_str = "LOW"; break;
-            case TransactionAnalysis::MEDIUM: level_str = "MEDIUM"; break;
-            case TransactionAnalysis::HIGH: level_str = "HIGH"; break;
-        }
+    void log_analysis_result(const TransactionInfo& tx, const TransactionAnalysis& analysis) {
+        char tx_hash[17];
+        tx.hash.short_hex<7>(tx_hash);
+        
+        const char* level_str = risk_level_name(analysis.risk_level);
         
         if (analysis.risk_level == TransactionAnalysis::HIGH) {
             LOG_WARN("🚨 HIGH RISK - TX: {} | Risk: {} | Profit: {:.4f} ETH | Slippage: {:.1f}%", 
-                    tx_hash.substr(0, 16), level_str, analysis.estimated_mev_profit_eth,
+                    tx_hash, level_str, analysis.estimated_mev_profit_eth,
                     analysis.slippage_percent);
         } else if (analysis.risk_level == TransactionAnalysis::MEDIUM) {
             LOG_INFO("⚠️  MEDIUM RISK - TX: {} | Profit: {:.4f} ETH", 
-                    tx_hash.substr(0, 16), analysis.estimated_mev_profit_eth);
+                    tx_hash, analysis.estimated_mev_profit_eth);
         } else {
             LOG_DEBUG("TX: {} | Risk: {} | Profit: {:.4f} ETH", 
-                     tx_hash.substr(0, 16), level_str, analysis.estimated_mev_profit_eth);
+                     tx_hash, level_str, analysis.estimated_mev_profit_eth);
         }
     }
 };
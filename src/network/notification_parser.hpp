@@ -0,0 +1,212 @@
+#pragma once
+#include <cstring>
+#include <string>
+#include <rapidjson/reader.h>
+#include "analytics/transaction.hpp"
+
+namespace mev_shield {
+
+// Single-pass SAX extractor for eth_subscription notifications:
+//
+//   {"jsonrpc":"2.0","method":"eth_subscription",
+//    "params":{"subscription":"0x..","result":"0x<hash>" | {<tx object>}}}
+//
+// It copies the subscription id and either the hash or the transaction
+// fields RiskEngine reads, decoding them straight into the binary record
+// without building a DOM or looking members up by name. Anything with a
+// different shape (subscription confirmations, errors, unknown methods)
+// makes parse() return false so the caller can fall back to the DOM. The
+// payload is read-only here, so a rejected frame can still be parsed in
+// situ afterwards.
+//
+// Reuse one parser per thread: the reader's stack and the output buffers
+// keep their capacity, so steady-state parsing does not allocate.
+class NotificationParser {
+public:
+    static constexpr size_t kMaxIdLength = 66;
+    static constexpr size_t kMaxHashLength = 66;
+
+    enum class ResultKind { None, Hash, Transaction };
+
+    struct Notification {
+        ResultKind kind = ResultKind::None;
+        char subscription[kMaxIdLength + 1] = {};
+        char hash[kMaxHashLength + 1] = {};  // also set for transaction results
+    };
+
+    // On success `out` is filled, and for transaction results so is `tx`.
+    // The payload must be NUL-terminated.
+    bool parse(const char* payload, Notification& out, PendingTransaction& tx) {
+        handler_.reset(out, tx);
+        rapidjson::StringStream stream(payload);
+        reader_.Parse<rapidjson::kParseDefaultFlags>(stream, handler_);
+        return !reader_.HasParseError() && handler_.complete();
+    }
+
+private:
+    static bool copy_bounded(char* dest, size_t max_length, const char* src, size_t length) {
+        if (length == 0 || length > max_length) {
+            return false;
+        }
+        std::memcpy(dest, src, length);
+        dest[length] = '\0';
+        return true;
+    }
+
+    static bool equals(const char* str, rapidjson::SizeType length, const char* literal) {
+        return length == std::strlen(literal) && std::memcmp(str, literal, length) == 0;
+    }
+
+    // Depth 1 is the envelope, 2 is "params", 3 is the transaction object;
+    // anything deeper (access lists etc.) is skipped
+    class Handler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+    public:
+        enum class Field { None, Jsonrpc, Method, Params, Subscription, Result,
+                           Hash, From, To, Input, Value };
+
+        void reset(Notification& out, PendingTransaction& tx) {
+            out_ = &out;
+            tx_ = &tx;
+            out.kind = ResultKind::None;
+            out.subscription[0] = '\0';
+            out.hash[0] = '\0';
+            tx.reset();
+            depth_ = 0;
+            field_ = Field::None;
+            method_ok_ = false;
+            has_subscription_ = false;
+            has_tx_hash_ = false;
+        }
+
+        bool complete() const {
+            if (out_->kind == ResultKind::Transaction && !has_tx_hash_) {
+                return false;
+            }
+            return method_ok_ && has_subscription_ && out_->kind != ResultKind::None;
+        }
+
+        // null, bools and numbers are only expected inside the transaction
+        bool Default() {
+            field_ = Field::None;
+            return depth_ >= 3;
+        }
+
+        bool String(const char* str, rapidjson::SizeType length, bool) {
+            Field field = field_;
+            field_ = Field::None;
+
+            if (depth_ == 1) {
+                if (field == Field::Method) {
+                    method_ok_ = equals(str, length, "eth_subscription");
+                    return method_ok_;
+                }
+                return field == Field::Jsonrpc;
+            }
+            if (depth_ == 2) {
+                if (field == Field::Subscription) {
+                    has_subscription_ = copy_bounded(out_->subscription, kMaxIdLength, str, length);
+                    return has_subscription_;
+                }
+                if (field == Field::Result) {
+                    out_->kind = ResultKind::Hash;
+                    return copy_bounded(out_->hash, kMaxHashLength, str, length);
+                }
+                return false;
+            }
+            if (depth_ == 3) {
+                // Malformed optional fields stay zeroed, as in decode_transaction
+                switch (field) {
+                    case Field::Hash:
+                        has_tx_hash_ = tx_->set_hash(str, length) &&
+                                       copy_bounded(out_->hash, kMaxHashLength, str, length);
+                        return has_tx_hash_;
+                    case Field::From: tx_->set_from(str, length); break;
+                    case Field::To: tx_->set_to(str, length); break;
+                    case Field::Input: tx_->set_calldata(str, length); break;
+                    case Field::Value: tx_->set_value(str, length); break;
+                    default: break;
+                }
+            }
+            return true;
+        }
+
+        bool Key(const char* str, rapidjson::SizeType length, bool) {
+            if (depth_ == 1) {
+                field_ = equals(str, length, "jsonrpc") ? Field::Jsonrpc
+                       : equals(str, length, "method") ? Field::Method
+                       : equals(str, length, "params") ? Field::Params : Field::None;
+                return field_ != Field::None;
+            }
+            if (depth_ == 2) {
+                field_ = equals(str, length, "subscription") ? Field::Subscription
+                       : equals(str, length, "result") ? Field::Result : Field::None;
+                return field_ != Field::None;
+            }
+            if (depth_ == 3) {
+                field_ = equals(str, length, "hash") ? Field::Hash
+                       : equals(str, length, "from") ? Field::From
+                       : equals(str, length, "to") ? Field::To
+                       : equals(str, length, "input") ? Field::Input
+                       : equals(str, length, "value") ? Field::Value : Field::None;
+            }
+            return true;
+        }
+
+        bool StartObject() {
+            Field field = field_;
+            field_ = Field::None;
+
+            if (depth_ == 0 ||
+                (depth_ == 1 && field == Field::Params)) {
+                depth_++;
+                return true;
+            }
+            if (depth_ == 2) {
+                if (field != Field::Result) {
+                    return false;
+                }
+                out_->kind = ResultKind::Transaction;
+                depth_++;
+                return true;
+            }
+            if (depth_ >= 3) {
+                depth_++;
+                return true;
+            }
+            return false;
+        }
+
+        bool EndObject(rapidjson::SizeType) {
+            depth_--;
+            return true;
+        }
+
+        bool StartArray() {
+            field_ = Field::None;
+            if (depth_ < 3) {
+                return false;
+            }
+            depth_++;
+            return true;
+        }
+
+        bool EndArray(rapidjson::SizeType) {
+            depth_--;
+            return true;
+        }
+
+    private:
+        Notification* out_ = nullptr;
+        PendingTransaction* tx_ = nullptr;
+        int depth_ = 0;
+        Field field_ = Field::None;
+        bool method_ok_ = false;
+        bool has_subscription_ = false;
+        bool has_tx_hash_ = false;
+    };
+
+    rapidjson::Reader reader_;
+    Handler handler_;
+};
+
+} // namespace mev_shield
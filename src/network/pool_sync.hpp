@@ -0,0 +1,298 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <rapidjson/document.h>
+#include "analytics/abi.hpp"
+#include "analytics/pool_cache.hpp"
+#include "common/eth_types.hpp"
+#include "common/hex.hpp"
+#include "common/logger.hpp"
+#include "network/rpc_client.hpp"
+
+namespace mev_shield {
+
+// Feeds the PoolCache from the node. New pools requested by the analysis
+// workers are read once with batched eth_calls (getReserves for V2 pairs,
+// slot0 + liquidity for V3 pools); after that the Sync and V3 Swap logs
+// pushed over the mempool websocket keep them current, so steady-state
+// pricing costs no RPC at all.
+//
+// V3 liquidity only changes through Swap logs here; a Mint or Burn inside
+// the active range is picked up with the pool's next swap.
+class PoolSync {
+public:
+    PoolSync(const std::string& http_url,
+             std::shared_ptr<PoolCache> cache,
+             size_t batch_size = 50,
+             std::chrono::milliseconds flush_interval = std::chrono::milliseconds(50))
+        : http_url_(http_url)
+        , cache_(std::move(cache))
+        , batch_size_(batch_size > 0 ? batch_size : 1)
+        , flush_interval_(flush_interval) {}
+
+    ~PoolSync() {
+        stop();
+    }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        worker_ = std::thread([this]() { run_worker(); });
+        LOG_INFO("Pool sync started: batch={}, flush={}ms", batch_size_, flush_interval_.count());
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // eth_subscribe request for every Sync and V3 Swap log on chain. The
+    // filter has no address list because the watched set grows at runtime;
+    // logs for pools outside the cache are dropped after one lookup.
+    static std::string subscribe_message(int request_id) {
+        return R"({"jsonrpc":"2.0","id":)" + std::to_string(request_id) +
+               R"(,"method":"eth_subscribe","params":["logs",{"topics":[[")" +
+               topic_hex(pool_events::kSyncTopic) + R"(",")" +
+               topic_hex(pool_events::kSwapV3Topic) + R"("]]}]})";
+    }
+
+    // One log object from the "logs" subscription; runs on the I/O thread.
+    // Returns false for malformed or unrelated logs.
+    bool apply_log(const rapidjson::Value& log) {
+        if (!log.IsObject() || (log.HasMember("removed") && log["removed"].IsBool() && log["removed"].GetBool())) {
+            return false;
+        }
+        Address pool;
+        Hash32 topic;
+        Uint256 block_number;
+        Uint256 log_index;
+        uint8_t data[kMaxLogData];
+        size_t data_size = 0;
+        if (!read_fixed(log, "address", pool) || !read_topic0(log, topic) ||
+            !read_quantity(log, "blockNumber", block_number) ||
+            !read_quantity(log, "logIndex", log_index) ||
+            !log.HasMember("data") || !read_bytes(log["data"], data, sizeof(data), data_size)) {
+            malformed_logs_++;
+            return false;
+        }
+
+        uint64_t block = block_number.low_u64();
+        uint32_t index = static_cast<uint32_t>(log_index.low_u64());
+        if (std::memcmp(topic.bytes, pool_events::kSyncTopic.data(), Hash32::kSize) == 0 && data_size == 64) {
+            cache_->apply_sync(pool, block, index, word(data, 0), word(data, 1));
+            return true;
+        }
+        // Swap(sender, recipient, amount0, amount1, sqrtPriceX96, liquidity, tick)
+        if (std::memcmp(topic.bytes, pool_events::kSwapV3Topic.data(), Hash32::kSize) == 0 && data_size == 160) {
+            cache_->apply_swap(pool, block, index, word(data, 2), word(data, 3), tick_at(data, 4));
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t bootstrapped_count() const { return bootstrapped_.load(); }
+    uint64_t missing_count() const { return missing_.load(); }
+    uint64_t failed_batch_count() const { return failed_batches_.load(); }
+    uint64_t malformed_log_count() const { return malformed_logs_.load(); }
+
+private:
+    static constexpr size_t kMaxLogData = 160;     // V3 Swap: five words
+    static constexpr size_t kMaxCallResult = 224;  // slot0(): seven words
+
+    std::string http_url_;
+    std::shared_ptr<PoolCache> cache_;
+    size_t batch_size_;
+    std::chrono::milliseconds flush_interval_;
+
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    std::atomic<uint64_t> bootstrapped_{0};
+    std::atomic<uint64_t> missing_{0};
+    std::atomic<uint64_t> failed_batches_{0};
+    std::atomic<uint64_t> malformed_logs_{0};
+
+    static std::string topic_hex(const std::array<uint8_t, 32>& topic) {
+        std::string text(2 + 2 * topic.size(), '0');
+        text[1] = 'x';
+        hex::encode(topic.data(), topic.size(), &text[2]);
+        return text;
+    }
+
+    static Uint256 word(const uint8_t* data, size_t index) {
+        return Uint256::from_be_bytes(data + index * abi::kWordSize);
+    }
+
+    // int24 ticks arrive sign-extended to 256 bits; the low four bytes
+    // already hold the two's complement int32
+    static int32_t tick_at(const uint8_t* data, size_t index) {
+        const uint8_t* low = data + index * abi::kWordSize + 28;
+        uint32_t raw = (uint32_t{low[0]} << 24) | (uint32_t{low[1]} << 16) |
+                       (uint32_t{low[2]} << 8) | uint32_t{low[3]};
+        return static_cast<int32_t>(raw);
+    }
+
+    template <size_t N>
+    static bool read_fixed(const rapidjson::Value& object, const char* name, FixedBytes<N>& out) {
+        auto member = object.FindMember(name);
+        return member != object.MemberEnd() && member->value.IsString() &&
+               FixedBytes<N>::from_hex(member->value.GetString(), member->value.GetStringLength(), out);
+    }
+
+    static bool read_topic0(const rapidjson::Value& log, Hash32& out) {
+        auto topics = log.FindMember("topics");
+        if (topics == log.MemberEnd() || !topics->value.IsArray() || topics->value.Empty()) {
+            return false;
+        }
+        const auto& topic = topics->value[rapidjson::SizeType(0)];
+        return topic.IsString() && Hash32::from_hex(topic.GetString(), topic.GetStringLength(), out);
+    }
+
+    static bool read_quantity(const rapidjson::Value& object, const char* name, Uint256& out) {
+        auto member = object.FindMember(name);
+        return member != object.MemberEnd() && member->value.IsString() &&
+               Uint256::from_hex(member->value.GetString(), member->value.GetStringLength(), out);
+    }
+
+    // "0x"-prefixed byte string of at most `capacity` bytes
+    static bool read_bytes(const rapidjson::Value& value, uint8_t* out, size_t capacity, size_t& size) {
+        if (!value.IsString()) {
+            return false;
+        }
+        const char* text = value.GetString();
+        size_t length = value.GetStringLength();
+        if (!hex::has_prefix(text, length) || (length - 2) % 2 != 0 || (length - 2) / 2 > capacity) {
+            return false;
+        }
+        size = (length - 2) / 2;
+        return hex::decode(text + 2, size, out);
+    }
+
+    void run_worker() {
+        // SimpleRPCClient keeps one curl handle for keep-alive
+        SimpleRPCClient client(http_url_);
+        std::vector<PoolCache::Request> batch;
+        batch.reserve(batch_size_);
+
+        while (running_) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_for(lock, flush_interval_, [this]() { return !running_.load(); });
+            }
+            if (!running_) {
+                break;
+            }
+
+            // Drain everything queued since the last pass, a batch at a time
+            PoolCache::Request request;
+            while (running_) {
+                while (batch.size() < batch_size_ && cache_->next_request(request)) {
+                    batch.push_back(request);
+                }
+                if (batch.empty()) {
+                    break;
+                }
+                bootstrap(client, batch);
+                batch.clear();
+            }
+        }
+    }
+
+    void bootstrap(SimpleRPCClient& client, const std::vector<PoolCache::Request>& batch) {
+        static const std::string kGetReservesData = selector_hex(pool_events::kGetReserves);
+        static const std::string kSlot0Data = selector_hex(pool_events::kSlot0);
+        static const std::string kLiquidityData = selector_hex(pool_events::kLiquidity);
+
+        // V2 pairs need one call, V3 pools two; first_call maps pool -> call id
+        std::vector<SimpleRPCClient::EthCall> calls;
+        std::vector<size_t> first_call;
+        calls.reserve(batch.size() * 2);
+        first_call.reserve(batch.size());
+        for (const auto& request : batch) {
+            first_call.push_back(calls.size());
+            std::string pool = request.pool.to_hex();
+            if (request.venue == PoolVenue::UniswapV3) {
+                calls.push_back({pool, kSlot0Data});
+                calls.push_back({pool, kLiquidityData});
+            } else {
+                calls.push_back({pool, kGetReservesData});
+            }
+        }
+
+        rapidjson::Document response = client.eth_call_batch(calls);
+        if (response.HasParseError() || !response.IsArray()) {
+            failed_batches_++;
+            LOG_DEBUG("Pool bootstrap batch of {} pools failed", batch.size());
+            for (const auto& request : batch) {
+                cache_->mark_idle(request.pool);
+            }
+            return;
+        }
+
+        std::vector<const rapidjson::Value*> results(calls.size(), nullptr);
+        for (const auto& entry : response.GetArray()) {
+            if (entry.IsObject() && entry.HasMember("id") && entry["id"].IsUint64() &&
+                entry["id"].GetUint64() < results.size() && entry.HasMember("result")) {
+                results[entry["id"].GetUint64()] = &entry["result"];
+            }
+        }
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            apply_result(batch[i], results.data() + first_call[i]);
+        }
+    }
+
+    void apply_result(const PoolCache::Request& request, const rapidjson::Value* const* results) {
+        uint8_t state[kMaxCallResult];
+        uint8_t liquidity[kMaxCallResult];
+        size_t state_size = 0;
+        size_t liquidity_size = 0;
+        bool v3 = request.venue == PoolVenue::UniswapV3;
+
+        if (!results[0] || !read_bytes(*results[0], state, sizeof(state), state_size) ||
+            (v3 && (!results[1] || !read_bytes(*results[1], liquidity, sizeof(liquidity), liquidity_size)))) {
+            cache_->mark_idle(request.pool);  // RPC error; retried on next demand
+            return;
+        }
+        // eth_call on an address without code returns "0x": the pair was
+        // never created
+        if (state_size < 2 * abi::kWordSize || (v3 && liquidity_size < abi::kWordSize)) {
+            missing_++;
+            cache_->mark_missing(request.pool);
+            return;
+        }
+
+        if (v3) {
+            cache_->apply_v3_state(request.pool, word(state, 0), tick_at(state, 1), word(liquidity, 0));
+        } else {
+            cache_->apply_v2_reserves(request.pool, word(state, 0), word(state, 1));
+        }
+        bootstrapped_++;
+    }
+
+    static std::string selector_hex(uint32_t selector) {
+        uint8_t bytes[4] = {static_cast<uint8_t>(selector >> 24), static_cast<uint8_t>(selector >> 16),
+                            static_cast<uint8_t>(selector >> 8), static_cast<uint8_t>(selector)};
+        std::string text(10, '0');
+        text[1] = 'x';
+        hex::encode(bytes, sizeof(bytes), &text[2]);
+        return text;
+    }
+};
+
+} // namespace mev_shield
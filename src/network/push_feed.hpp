@@ -0,0 +1,549 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include "analytics/transaction.hpp"
+#include "analytics/transaction_analysis.hpp"
+#include "common/logger.hpp"
+#include "network/analysis_json.hpp"
+
+namespace mev_shield {
+
+// A complete, immutable WebSocket frame (header and payload). One is built
+// per message and shared by every subscriber's queue; sending writes the
+// shared bytes, so fan-out costs a reference count per client, not a copy.
+using PushFrame = std::shared_ptr<const std::string>;
+
+// Unmasked server-to-client frame (RFC 6455 section 5.2), still mutable
+// until it is handed out as a PushFrame
+inline std::shared_ptr<std::string> make_push_frame(uint8_t opcode, const char* payload, size_t size) {
+    auto frame = std::make_shared<std::string>();
+    frame->reserve(size + 10);
+    *frame += static_cast<char>(0x80 | opcode);
+    if (size < 126) {
+        *frame += static_cast<char>(size);
+    } else if (size <= 0xFFFF) {
+        *frame += static_cast<char>(126);
+        *frame += static_cast<char>(size >> 8);
+        *frame += static_cast<char>(size);
+    } else {
+        *frame += static_cast<char>(127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            *frame += static_cast<char>(static_cast<uint64_t>(size) >> shift);
+        }
+    }
+    frame->append(payload, size);
+    return frame;
+}
+
+// What a subscriber does when its send queue is full
+enum class OverflowPolicy : uint8_t {
+    DropOldest,       // discard the oldest queued message
+    DropLowestRisk,   // discard the oldest message of the lowest queued risk level
+    Disconnect        // close the connection (1008) and let the client resync
+};
+
+inline OverflowPolicy parse_overflow_policy(const std::string& name) {
+    if (name == "drop_low" || name == "drop_lowest_risk") {
+        return OverflowPolicy::DropLowestRisk;
+    }
+    if (name == "disconnect") {
+        return OverflowPolicy::Disconnect;
+    }
+    return OverflowPolicy::DropOldest;
+}
+
+struct PushSubscriberStats {
+    uint64_t id = 0;
+    size_t queued = 0;           // messages waiting for the socket
+    uint64_t dropped = 0;        // messages discarded by the overflow policy
+    uint64_t lag = 0;            // newest published seq minus newest written seq
+};
+
+class PushFeed;
+
+// One /ws client. Messages are queued from any thread into a bounded
+// queue and written from the connection's strand, up to kMaxBatch queued
+// frames per gather write. A client that cannot keep up only ever loses
+// its own messages: the overflow policy runs under this subscriber's lock
+// and never waits for its socket. Client frames are read only to answer
+// pings and the closing handshake.
+class PushSubscriber : public std::enable_shared_from_this<PushSubscriber> {
+public:
+    static constexpr size_t kMaxClientFrame = 4096;
+    static constexpr size_t kMaxBatch = 64;
+    // How long a queued close frame may wait behind a stalled socket
+    static constexpr std::chrono::seconds kCloseTimeout{5};
+
+    PushSubscriber(PushFeed& feed, uint64_t id, size_t capacity, OverflowPolicy policy, uint64_t start_seq,
+                   boost::asio::ip::tcp::socket socket, std::string buffered, std::shared_ptr<void> slot)
+        : feed_(feed)
+        , id_(id)
+        , capacity_(capacity > 0 ? capacity : 1)
+        , policy_(policy)
+        , socket_(std::move(socket))
+        , slot_(std::move(slot))
+        , close_timer_(socket_.get_executor())
+        , buffer_(kMaxClientFrame + 14)
+        , last_sent_seq_(start_seq) {
+        used_ = std::min(buffered.size(), buffer_.size());
+        std::memcpy(buffer_.data(), buffered.data(), used_);
+    }
+
+    void start() {
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()]() { self->process(); });
+    }
+
+    // Any thread. `seq` orders messages; the feed calls this in seq order.
+    void send(const PushFrame& frame, uint64_t seq, TransactionAnalysis::RiskLevel risk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closing_) {
+            return;
+        }
+        if (queued_messages_ >= capacity_ && !make_room(risk)) {
+            return;
+        }
+        queue_.push_back(QueuedFrame{frame, seq, risk});
+        ++queued_messages_;
+        kick();
+    }
+
+    // Any thread: queues a close frame, then shuts the socket down once it
+    // has been written or kCloseTimeout has passed
+    void close(uint16_t code) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        close_locked(code);
+    }
+
+    PushSubscriberStats stats(uint64_t published_seq) const {
+        PushSubscriberStats stats;
+        stats.id = id_;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats.queued = queued_messages_;
+        }
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        uint64_t sent = last_sent_seq_.load(std::memory_order_relaxed);
+        stats.lag = published_seq > sent ? published_seq - sent : 0;
+        return stats;
+    }
+
+private:
+    struct QueuedFrame {
+        PushFrame frame;
+        uint64_t seq;                            // 0 for control frames, never dropped
+        TransactionAnalysis::RiskLevel risk;
+    };
+
+    PushFeed& feed_;
+    uint64_t id_;
+    size_t capacity_;
+    OverflowPolicy policy_;
+    boost::asio::ip::tcp::socket socket_;
+    std::shared_ptr<void> slot_;             // the server's connection slot, held while open
+    boost::asio::steady_timer close_timer_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+
+    mutable std::mutex mutex_;       // guards the members below up to in_flight_
+    std::deque<QueuedFrame> queue_;
+    size_t queued_messages_ = 0;     // data frames in queue_
+    bool writing_ = false;
+    bool closing_ = false;
+    bool finished_ = false;
+
+    std::vector<QueuedFrame> in_flight_;     // strand only
+    std::vector<boost::asio::const_buffer> buffers_;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> last_sent_seq_;
+
+    // Caller holds mutex_
+    void kick() {
+        if (!writing_) {
+            writing_ = true;
+            boost::asio::post(socket_.get_executor(), [self = shared_from_this()]() { self->write_queued(); });
+        }
+    }
+
+    // Caller holds mutex_
+    void close_locked(uint16_t code) {
+        if (closing_) {
+            return;
+        }
+        char payload[2] = {static_cast<char>(code >> 8), static_cast<char>(code)};
+        queue_.push_back(QueuedFrame{make_push_frame(0x8, payload, sizeof(payload)), 0, TransactionAnalysis::LOW});
+        closing_ = true;
+        kick();
+        boost::asio::post(socket_.get_executor(), [self = shared_from_this()]() {
+            self->close_timer_.expires_after(kCloseTimeout);
+            self->close_timer_.async_wait([self](const boost::system::error_code& ec) {
+                if (!ec) {
+                    self->finish();
+                }
+            });
+        });
+    }
+
+    // Caller holds mutex_ and the queue is full. False when the incoming
+    // message is the one to drop.
+    bool make_room(TransactionAnalysis::RiskLevel incoming) {
+        auto victim = queue_.end();
+        if (policy_ == OverflowPolicy::Disconnect) {
+            size_t discarded = queued_messages_ + 1;
+            queue_.clear();
+            queued_messages_ = 0;
+            count_drops(discarded);
+            count_disconnect();
+            close_locked(1008);
+            return false;
+        }
+        if (policy_ == OverflowPolicy::DropLowestRisk) {
+            for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+                if (it->seq != 0 && (victim == queue_.end() || it->risk < victim->risk)) {
+                    victim = it;
+                }
+            }
+            if (victim == queue_.end() || incoming < victim->risk) {
+                count_drops(1);
+                return false;
+            }
+        } else {
+            victim = std::find_if(queue_.begin(), queue_.end(), [](const QueuedFrame& queued) { return queued.seq != 0; });
+            if (victim == queue_.end()) {
+                count_drops(1);
+                return false;
+            }
+        }
+        queue_.erase(victim);
+        --queued_messages_;
+        count_drops(1);
+        return true;
+    }
+
+    void count_drops(uint64_t count);
+    void count_disconnect();
+
+    void write_queued() {
+        bool shutdown = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t batch = std::min(queue_.size(), kMaxBatch);
+            if (batch == 0) {
+                writing_ = false;
+                shutdown = closing_;
+            } else {
+                for (size_t i = 0; i < batch; ++i) {
+                    if (queue_.front().seq != 0) {
+                        --queued_messages_;
+                    }
+                    in_flight_.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+            }
+        }
+        if (in_flight_.empty()) {
+            if (shutdown) {
+                finish();
+            }
+            return;
+        }
+        buffers_.clear();
+        for (const QueuedFrame& queued : in_flight_) {
+            buffers_.push_back(boost::asio::buffer(*queued.frame));
+        }
+        boost::asio::async_write(socket_, buffers_,
+            [self = shared_from_this()](const boost::system::error_code& ec, size_t) {
+                for (const QueuedFrame& queued : self->in_flight_) {
+                    if (queued.seq != 0) {
+                        self->last_sent_seq_.store(queued.seq, std::memory_order_relaxed);
+                    }
+                }
+                self->in_flight_.clear();
+                if (ec) {
+                    self->finish();
+                    return;
+                }
+                self->write_queued();
+            });
+    }
+
+    void read() {
+        if (used_ == buffer_.size()) {
+            close(1009);         // message too big
+            return;
+        }
+        socket_.async_read_some(boost::asio::buffer(buffer_.data() + used_, buffer_.size() - used_),
+            [self = shared_from_this()](const boost::system::error_code& ec, size_t bytes) {
+                if (ec) {
+                    self->finish();
+                    return;
+                }
+                self->used_ += bytes;
+                self->process();
+            });
+    }
+
+    // Handles every complete client frame in the buffer, then reads on
+    void process() {
+        for (;;) {
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer_.data());
+            if (used_ < 2) {
+                break;
+            }
+            uint8_t opcode = data[0] & 0x0F;
+            bool masked = (data[1] & 0x80) != 0;
+            uint64_t length = data[1] & 0x7F;
+            size_t header = 2;
+            if (length == 126) {
+                if (used_ < 4) {
+                    break;
+                }
+                length = (uint64_t{data[2]} << 8) | data[3];
+                header = 4;
+            } else if (length == 127) {
+                if (used_ < 10) {
+                    break;
+                }
+                length = 0;
+                for (int i = 0; i < 8; ++i) {
+                    length = (length << 8) | data[2 + i];
+                }
+                header = 10;
+            }
+            if (!masked) {
+                close(1002);     // clients must mask (RFC 6455 section 5.1)
+                return;
+            }
+            if (length > kMaxClientFrame) {
+                close(1009);
+                return;
+            }
+            size_t total = header + 4 + static_cast<size_t>(length);
+            if (used_ < total) {
+                break;
+            }
+
+            char* payload = buffer_.data() + header + 4;
+            const uint8_t* mask = data + header;
+            for (size_t i = 0; i < length; ++i) {
+                payload[i] = static_cast<char>(payload[i] ^ mask[i & 3]);
+            }
+            if (opcode == 0x8) {
+                close(1000);
+                return;
+            }
+            if (opcode == 0x9) {
+                // Pongs bypass the bound; a client can only have one ping
+                // per read in flight
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!closing_) {
+                    queue_.push_back(QueuedFrame{make_push_frame(0xA, payload, static_cast<size_t>(length)),
+                                                 0, TransactionAnalysis::LOW});
+                    kick();
+                }
+            }
+            // Data frames and pongs from clients carry nothing we use
+
+            std::memmove(buffer_.data(), buffer_.data() + total, used_ - total);
+            used_ -= total;
+        }
+        read();
+    }
+
+    void finish();
+};
+
+// Broadcasts analyses to every /ws subscriber. publish() runs on the
+// analysis workers: it serializes each qualifying result once, outside any
+// lock, and hands the same frame to every subscriber's bounded queue,
+// never touching a socket.
+//
+// Messages carry a feed-wide "seq" that increases by one per message, so
+// a client sees a gap exactly when its overflow policy dropped something.
+// Stamping the seq and fanning out happen under publish_mutex_ to keep
+// every queue in seq order; that section only copies frame pointers.
+//
+// The subscriber list is copy-on-write: publishers take the current
+// vector with an atomic shared_ptr load; joins and leaves, which are
+// rare, copy the list under a mutex.
+class PushFeed {
+public:
+    using SubscriberList = std::vector<std::shared_ptr<PushSubscriber>>;
+
+    struct Options {
+        TransactionAnalysis::RiskLevel min_risk = TransactionAnalysis::MEDIUM;
+        size_t queue_messages = 1024;         // per subscriber
+        OverflowPolicy overflow = OverflowPolicy::DropOldest;
+    };
+
+    explicit PushFeed(const Options& options)
+        : options_(options)
+        , subscribers_(std::make_shared<SubscriberList>()) {}
+
+    size_t subscriber_count() const {
+        return std::atomic_load(&subscribers_)->size();
+    }
+
+    uint64_t published_count() const { return last_seq_.load(std::memory_order_relaxed); }
+    uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t slow_disconnect_count() const { return slow_disconnects_.load(std::memory_order_relaxed); }
+
+    std::vector<PushSubscriberStats> subscriber_stats() const {
+        std::shared_ptr<const SubscriberList> subscribers = std::atomic_load(&subscribers_);
+        uint64_t published = last_seq_.load(std::memory_order_relaxed);
+        std::vector<PushSubscriberStats> stats;
+        stats.reserve(subscribers->size());
+        for (const auto& subscriber : *subscribers) {
+            stats.push_back(subscriber->stats(published));
+        }
+        return stats;
+    }
+
+    // Upgrade handler: runs on the new subscriber's strand. `slot` is held
+    // until the socket closes, so subscribers count against the server's
+    // connection limit.
+    void subscribe(boost::asio::ip::tcp::socket socket, std::string buffered, std::shared_ptr<void> slot) {
+        auto subscriber = std::make_shared<PushSubscriber>(
+            *this, next_id_.fetch_add(1, std::memory_order_relaxed) + 1, options_.queue_messages,
+            options_.overflow, last_seq_.load(std::memory_order_relaxed), std::move(socket), std::move(buffered),
+            std::move(slot));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return;
+            }
+            auto next = std::make_shared<SubscriberList>(*subscribers_);
+            next->push_back(subscriber);
+            std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(next)));
+            ++open_;
+        }
+        subscriber->start();
+    }
+
+    // Once per subscriber, when its socket is closed
+    void unsubscribe(const PushSubscriber* subscriber) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto next = std::make_shared<SubscriberList>();
+            for (const auto& current : *subscribers_) {
+                if (current.get() != subscriber) {
+                    next->push_back(current);
+                }
+            }
+            std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(next)));
+            --open_;
+        }
+        closed_cv_.notify_all();
+    }
+
+    // Analysis worker threads
+    void publish(const TransactionInfo& tx, const TransactionAnalysis& analysis) {
+        if (analysis.risk_level < options_.min_risk) {
+            return;
+        }
+        if (std::atomic_load(&subscribers_)->empty()) {
+            return;
+        }
+
+        // The seq is written into a fixed-width slot once it is known;
+        // JSON allows the trailing spaces
+        thread_local std::string payload;
+        payload.clear();
+        payload += "{\"type\":\"analysis\",\"seq\":";
+        size_t seq_at = payload.size();
+        payload.append(kSeqWidth, ' ');
+        payload += ",\"data\":";
+        uint64_t now_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        append_analysis_json(payload, tx, analysis, now_ms);
+        payload += '}';
+        std::shared_ptr<std::string> frame = make_push_frame(0x1, payload.data(), payload.size());
+        size_t frame_seq_at = frame->size() - payload.size() + seq_at;
+
+        std::lock_guard<std::mutex> lock(publish_mutex_);
+        uint64_t seq = last_seq_.load(std::memory_order_relaxed) + 1;
+        std::string digits = std::to_string(seq);
+        frame->replace(frame_seq_at, digits.size(), digits);
+        PushFrame shared = std::move(frame);
+        for (const auto& subscriber : *std::atomic_load(&subscribers_)) {
+            subscriber->send(shared, seq, analysis.risk_level);
+        }
+        last_seq_.store(seq, std::memory_order_relaxed);
+    }
+
+    // Sends every subscriber a going-away close and refuses new ones
+    void close_all() {
+        std::shared_ptr<const SubscriberList> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            subscribers = std::atomic_load(&subscribers_);
+            std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::make_shared<SubscriberList>()));
+        }
+        for (const auto& subscriber : *subscribers) {
+            subscriber->close(1001);
+        }
+    }
+
+    // After close_all(): true once every subscriber's socket is closed,
+    // i.e. its close frame was written or gave up after kCloseTimeout.
+    // The I/O threads must keep running meanwhile.
+    bool wait_closed(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return closed_cv_.wait_for(lock, timeout, [this]() { return open_ == 0; });
+    }
+
+private:
+    friend class PushSubscriber;
+
+    static constexpr size_t kSeqWidth = 20;      // digits of UINT64_MAX
+
+    Options options_;
+    std::mutex mutex_;               // serializes list updates
+    std::condition_variable closed_cv_;
+    bool closed_ = false;
+    size_t open_ = 0;                // subscribers whose socket is not closed yet
+    std::shared_ptr<const SubscriberList> subscribers_;
+    std::mutex publish_mutex_;       // seq stamping and fan-out
+    std::atomic<uint64_t> last_seq_{0};
+    std::atomic<uint64_t> next_id_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> slow_disconnects_{0};
+};
+
+inline void PushSubscriber::count_drops(uint64_t count) {
+    dropped_.fetch_add(count, std::memory_order_relaxed);
+    feed_.dropped_.fetch_add(count, std::memory_order_relaxed);
+}
+
+inline void PushSubscriber::count_disconnect() {
+    feed_.slow_disconnects_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void PushSubscriber::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_) {
+            return;      // a failed read and a failed write both end here
+        }
+        finished_ = true;
+        closing_ = true;
+    }
+    close_timer_.cancel();
+    boost::system::error_code ignored;
+    socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+    socket_.close(ignored);
+    slot_.reset();
+    feed_.unsubscribe(this);
+}
+
+} // namespace mev_shield
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mev_shield {
+
+// A serialized response body and the data version it was built from
+struct CachedBody {
+    uint64_t version = 0;
+    std::string etag;               // quoted, ready for the ETag header
+    std::string body;
+};
+
+// The current serialized body of one endpoint. Polls whose data version
+// has not moved share the cached body (and its ETag) without serializing
+// anything; the first poll after a change rebuilds it once while other
+// pollers of that endpoint wait for the result instead of building too.
+//
+// For a monotonic source, a poll that arrives with a version older than
+// the cached one (it pinned its data just before an update) gets a body
+// built for it alone; the newer cached body stays in place.
+class ResponseCache {
+public:
+    // `tag` distinguishes endpoints and process runs inside the ETag.
+    // `monotonic` when versions only ever increase.
+    explicit ResponseCache(std::string tag, bool monotonic = false)
+        : tag_(std::move(tag))
+        , monotonic_(monotonic) {}
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // `build` runs under this cache's lock and only when `version` differs
+    // from the cached one
+    template <typename Build>
+    std::shared_ptr<const CachedBody> get(uint64_t version, Build&& build) {
+        std::shared_ptr<const CachedBody> cached = std::atomic_load(&current_);
+        if (cached && cached->version == version) {
+            return cached;
+        }
+        std::lock_guard<std::mutex> lock(build_mutex_);
+        cached = std::atomic_load(&current_);
+        if (cached && cached->version == version) {
+            return cached;
+        }
+        auto next = std::make_shared<CachedBody>();
+        next->version = version;
+        next->body = build();
+        char etag[64];
+        std::snprintf(etag, sizeof(etag), "\"%s-%llx\"", tag_.c_str(), static_cast<unsigned long long>(version));
+        next->etag = etag;
+        builds_.fetch_add(1, std::memory_order_relaxed);
+        if (monotonic_ && cached && version < cached->version) {
+            return next;
+        }
+        cached = std::move(next);
+        std::atomic_store(&current_, cached);
+        return cached;
+    }
+
+    uint64_t build_count() const { return builds_.load(std::memory_order_relaxed); }
+
+private:
+    std::string tag_;
+    bool monotonic_;
+    std::mutex build_mutex_;
+    std::shared_ptr<const CachedBody> current_;
+    std::atomic<uint64_t> builds_{0};
+};
+
+// True when an If-None-Match header value names `etag` (or is "*").
+// Weak tags match too: W/"x" contains "x".
+inline bool etag_matches(const std::string& if_none_match, const std::string& etag) {
+    if (if_none_match.empty() || etag.empty()) {
+        return false;
+    }
+    if (if_none_match == "*") {
+        return true;
+    }
+    return if_none_match.find(etag) != std::string::npos;
+}
+
+} // namespace mev_shield
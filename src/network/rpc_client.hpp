@@ -11,6 +11,7 @@
 #pragma once
 #include <curl/curl.h>
 #include <string>
+#include <vector>
 #include <rapidjson/document.h>
 #include "common/logger.hpp"
 
@@ -18,14 +19,25 @@ namespace mev_shield {
 
 class SimpleRPCClient {
 public:
+    struct EthCall {
+        std::string to;
+        std::string data;
+    };
+    
     SimpleRPCClient(const std::string& http_url) : http_url_(http_url) {
         curl_global_init(CURL_GLOBAL_DEFAULT);
     }
     
     ~SimpleRPCClient() {
+        if (curl_) {
+            curl_easy_cleanup(curl_);
+        }
         curl_global_cleanup();
     }
     
+    SimpleRPCClient(const SimpleRPCClient&) = delete;
+    SimpleRPCClient& operator=(const SimpleRPCClient&) = delete;
+    
     rapidjson::Document get_transaction(const std::string& tx_hash) {
         std::string params = R"([")" + tx_hash + R"("])";
         std::string response = json_rpc_call("eth_getTransactionByHash", params);
@@ -35,6 +47,73 @@ public:
         return doc;
     }
     
+    // Fetches many transactions in a single HTTP round trip using a JSON-RPC
+    // batch array. The returned document is the raw response array; entries
+    // may arrive in any order and carry the index of their hash as "id".
+    rapidjson::Document get_transactions(const std::vector<std::string>& tx_hashes) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        
+        writer.StartArray();
+        for (size_t i = 0; i < tx_hashes.size(); ++i) {
+            writer.StartObject();
+            writer.Key("jsonrpc");
+            writer.String("2.0");
+            writer.Key("id");
+            writer.Uint64(i);
+            writer.Key("method");
+            writer.String("eth_getTransactionByHash");
+            writer.Key("params");
+            writer.StartArray();
+            writer.String(tx_hashes[i].c_str(), static_cast<rapidjson::SizeType>(tx_hashes[i].size()));
+            writer.EndArray();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        
+        std::string response = http_post(std::string(buffer.GetString(), buffer.GetSize()));
+        
+        rapidjson::Document doc;
+        doc.Parse(response.c_str());
+        return doc;
+    }
+    
+    // eth_call against "latest" for each entry, as one JSON-RPC batch. As
+    // with get_transactions, results carry their index as "id".
+    rapidjson::Document eth_call_batch(const std::vector<EthCall>& calls) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        
+        writer.StartArray();
+        for (size_t i = 0; i < calls.size(); ++i) {
+            writer.StartObject();
+            writer.Key("jsonrpc");
+            writer.String("2.0");
+            writer.Key("id");
+            writer.Uint64(i);
+            writer.Key("method");
+            writer.String("eth_call");
+            writer.Key("params");
+            writer.StartArray();
+            writer.StartObject();
+            writer.Key("to");
+            writer.String(calls[i].to.c_str(), static_cast<rapidjson::SizeType>(calls[i].to.size()));
+            writer.Key("data");
+            writer.String(calls[i].data.c_str(), static_cast<rapidjson::SizeType>(calls[i].data.size()));
+            writer.EndObject();
+            writer.String("latest");
+            writer.EndArray();
+            writer.EndObject();
+        }
+        writer.EndArray();
+        
+        std::string response = http_post(std::string(buffer.GetString(), buffer.GetSize()));
+        
+        rapidjson::Document doc;
+        doc.Parse(response.c_str());
+        return doc;
+    }
+    
     std::string get_gas_price() {
         std::string response = json_rpc_call("eth_gasPrice");
         
@@ -48,6 +127,7 @@ public:
 
 private:
     std::string http_url_;
+    CURL* curl_ = nullptr;  // reused so keep-alive saves a TLS handshake per call
     
     std::string json_rpc_call(const std::string& method, const std::string& params = "[]") {
         rapidjson::Document request;
@@ -72,33 +152,37 @@ private:
     }
     
     std::string http_post(const std::string& data) {
-        CURL* curl = curl_easy_init();
         std::string response;
         
-        if (!curl) {
+        if (!curl_) {
+            curl_ = curl_easy_init();
+        } else {
+            curl_easy_reset(curl_);
+        }
+        if (!curl_) {
             return "{}";
         }
         
-        curl_easy_setopt(curl, CURLOPT_URL, http_url_.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, data.length());
+        curl_easy_setopt(curl_, CURLOPT_URL, http_url_.c_str());
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, data.c_str());
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, data.length());
         
         struct curl_slist* headers = nullptr;
         headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
         
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, write_callback);
+        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response);
+        curl_easy_setopt(curl_, CURLOPT_TIMEOUT, 5L);
+        curl_easy_setopt(curl_, CURLOPT_TCP_NODELAY, 1L);
         
-        CURLcode res = curl_easy_perform(curl);
+        CURLcode res = curl_easy_perform(curl_);
         
         if (res != CURLE_OK) {
             response = "{\"error\": \"" + std::string(curl_easy_strerror(res)) + "\"}";
         }
         
         curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
         
         return response;
     }
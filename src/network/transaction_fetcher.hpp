@@ -0,0 +1,189 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <rapidjson/document.h>
+#include "common/eth_types.hpp"
+#include "common/latency_histogram.hpp"
+#include "common/logger.hpp"
+#include "common/ring_buffer.hpp"
+#include "network/rpc_client.hpp"
+
+namespace mev_shield {
+
+// Turns a stream of pending transaction hashes into transaction bodies.
+// Hashes are collected into batches (flushed when full or after
+// flush_interval) and resolved with one JSON-RPC batch request each, so the
+// number of HTTP round trips grows with batches rather than hashes.
+//
+// enqueue() runs on the websocket thread for every notification, so it only
+// copies the hash into a preallocated lock-free ring and never allocates.
+class TransactionFetcher {
+public:
+    using TransactionHandler = std::function<void(const rapidjson::Value& tx)>;
+
+    TransactionFetcher(const std::string& http_url,
+                       size_t batch_size = 50,
+                       std::chrono::milliseconds flush_interval = std::chrono::milliseconds(20),
+                       size_t fetch_threads = 2,
+                       size_t max_pending = 10000)
+        : http_url_(http_url)
+        , batch_size_(batch_size > 0 ? batch_size : 1)
+        , flush_interval_(flush_interval)
+        , fetch_threads_(fetch_threads > 0 ? fetch_threads : 1)
+        , pending_(round_up_pow2(max_pending)) {}
+
+    ~TransactionFetcher() {
+        stop();
+    }
+
+    // Called from the fetch threads once per transaction found on the node.
+    void set_transaction_handler(TransactionHandler handler) {
+        handler_ = handler;
+    }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        for (size_t i = 0; i < fetch_threads_; ++i) {
+            workers_.emplace_back([this]() { run_worker(); });
+        }
+        LOG_INFO("Transaction fetcher started: batch={}, flush={}ms, threads={}",
+                 batch_size_, flush_interval_.count(), fetch_threads_);
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers_.clear();
+    }
+
+    // Returns false when the hash is malformed or the backlog is full.
+    bool enqueue(const char* tx_hash) {
+        // Decoded up front so malformed hashes never reach the node and the
+        // backlog holds 32 bytes per hash instead of 67 characters
+        Hash32 hash;
+        if (!Hash32::from_hex(tx_hash, strnlen(tx_hash, kMaxHashLength + 1), hash)) {
+            malformed_++;
+            return false;
+        }
+        bool queued = pending_.try_push_with([&hash](PendingHash& slot) {
+            slot.hash = hash;
+        });
+        if (!queued) {
+            dropped_++;
+            return false;
+        }
+        // A wakeup lost to the unlocked push costs at most one flush interval
+        cv_.notify_one();
+        return true;
+    }
+
+    uint64_t fetched_count() const { return fetched_.load(); }
+    uint64_t missing_count() const { return missing_.load(); }
+    uint64_t dropped_count() const { return dropped_.load(); }
+    uint64_t malformed_count() const { return malformed_.load(); }
+    uint64_t failed_batch_count() const { return failed_batches_.load(); }
+    size_t backlog() const { return pending_.size(); }
+
+private:
+    static constexpr size_t kMaxHashLength = 66;  // "0x" + 64 hex digits
+
+    struct PendingHash {
+        Hash32 hash;
+    };
+
+    std::string http_url_;
+    size_t batch_size_;
+    std::chrono::milliseconds flush_interval_;
+    size_t fetch_threads_;
+    TransactionHandler handler_;
+
+    std::atomic<bool> running_{false};
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    RingBuffer<PendingHash> pending_;
+
+    std::atomic<uint64_t> fetched_{0};
+    std::atomic<uint64_t> missing_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> failed_batches_{0};
+
+    void run_worker() {
+        // SimpleRPCClient keeps one curl handle, so each thread owns a client
+        SimpleRPCClient client(http_url_);
+        std::vector<std::string> batch;
+        batch.reserve(batch_size_);
+
+        while (running_) {
+            {
+                // Wake when a full batch is ready or the flush window ends
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_for(lock, flush_interval_, [this]() {
+                    return !running_ || pending_.size() >= batch_size_;
+                });
+            }
+            if (!running_) {
+                break;
+            }
+
+            PendingHash hash;
+            while (batch.size() < batch_size_ && pending_.try_pop(hash)) {
+                batch.emplace_back(hash.hash.to_hex());
+            }
+
+            if (!batch.empty()) {
+                fetch_batch(client, batch);
+                batch.clear();
+            }
+        }
+    }
+
+    void fetch_batch(SimpleRPCClient& client, const std::vector<std::string>& batch) {
+        uint64_t start = StageLatency::now_ns();
+        rapidjson::Document response = client.get_transactions(batch);
+        StageLatency::get_instance().record(Stage::Fetch, StageLatency::now_ns() - start);
+
+        if (response.HasParseError() || !response.IsArray()) {
+            failed_batches_++;
+            LOG_DEBUG("Batch of {} transactions failed", batch.size());
+            return;
+        }
+
+        for (const auto& entry : response.GetArray()) {
+            if (!entry.IsObject() || !entry.HasMember("result") || !entry["result"].IsObject()) {
+                // null result: already mined or evicted from the node's pool
+                missing_++;
+                continue;
+            }
+
+            fetched_++;
+            if (handler_) {
+                try {
+                    handler_(entry["result"]);
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Transaction handler exception: {}", e.what());
+                }
+            }
+        }
+    }
+};
+
+} // namespace mev_shield
@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/hex.hpp"
+#include "common/ring_buffer.hpp"
+
+namespace mev_shield {
+
+// Per-provider race statistics for the merged mempool stream
+struct FeedStats {
+    // Upper bounds (ms) of the arrival-lag histogram buckets; the last
+    // bucket catches everything slower
+    static constexpr std::array<double, 11> kLagBucketsMs = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000
+    };
+
+    std::string provider;
+    uint64_t seen = 0;         // notifications received from this provider
+    uint64_t wins = 0;         // hashes this provider delivered first
+    double win_rate = 0.0;     // wins / unique hashes across all providers
+    uint64_t late = 0;         // duplicates, each one recorded in the histogram
+    double lag_sum_ms = 0.0;
+    std::array<uint64_t, kLagBucketsMs.size() + 1> lag_buckets{};
+
+    // Connection health, filled in by MempoolMonitor
+    bool connected = false;
+    uint64_t reconnects = 0;
+    double last_gap_ms = 0.0;  // outage length until the feed resubscribed
+};
+
+// First-seen-wins deduplication across several websocket feeds. Only the
+// I/O thread calls observe(); stats can be read from any thread.
+//
+// The hash table is a fixed array with bounded linear probing: a lookup
+// scans at most kProbeLimit slots and a new hash replaces the oldest slot in
+// its window once the table is full, so memory never grows and no insert
+// allocates. A transaction hash is already uniformly random, so its first 8
+// bytes serve as the key directly.
+class TxDeduplicator {
+public:
+    static constexpr size_t kProbeLimit = 16;
+
+    explicit TxDeduplicator(std::vector<std::string> provider_names,
+                            size_t capacity_pow2 = 1 << 17)
+        : slots_(round_up_pow2(capacity_pow2))
+        , mask_(slots_.size() - 1)
+        , providers_(provider_names.size()) {
+        for (size_t i = 0; i < provider_names.size(); ++i) {
+            providers_[i].name = std::move(provider_names[i]);
+        }
+    }
+
+    // Returns true when this is the first time any provider delivered the hash
+    bool observe(const char* tx_hash, size_t provider,
+                 std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) {
+        uint64_t key = fingerprint(tx_hash);
+        int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now.time_since_epoch()).count();
+        ProviderCounters& counters = providers_[provider];
+        counters.seen.fetch_add(1, std::memory_order_relaxed);
+
+        size_t index = key & mask_;
+        Slot* victim = &slots_[index];
+        for (size_t probe = 0; probe < kProbeLimit; ++probe) {
+            Slot& slot = slots_[(index + probe) & mask_];
+            if (slot.key == key) {
+                record_lag(counters, now_ns - slot.first_seen_ns);
+                return false;
+            }
+            if (slot.key == 0) {
+                victim = &slot;
+                break;
+            }
+            if (slot.first_seen_ns < victim->first_seen_ns) {
+                victim = &slot;
+            }
+        }
+
+        victim->key = key;
+        victim->first_seen_ns = now_ns;
+        unique_.fetch_add(1, std::memory_order_relaxed);
+        counters.wins.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t unique_count() const { return unique_.load(std::memory_order_relaxed); }
+
+    std::vector<FeedStats> snapshot() const {
+        std::vector<FeedStats> stats(providers_.size());
+        uint64_t unique = unique_count();
+        for (size_t i = 0; i < providers_.size(); ++i) {
+            const ProviderCounters& counters = providers_[i];
+            FeedStats& out = stats[i];
+            out.provider = counters.name;
+            out.seen = counters.seen.load(std::memory_order_relaxed);
+            out.wins = counters.wins.load(std::memory_order_relaxed);
+            out.win_rate = unique > 0 ? static_cast<double>(out.wins) / unique : 0.0;
+            out.late = counters.late.load(std::memory_order_relaxed);
+            out.lag_sum_ms = counters.lag_sum_us.load(std::memory_order_relaxed) / 1000.0;
+            for (size_t b = 0; b < out.lag_buckets.size(); ++b) {
+                out.lag_buckets[b] = counters.lag_buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+        return stats;
+    }
+
+    // First 8 bytes of a 0x-prefixed hex hash; 0 is reserved for empty slots
+    static uint64_t fingerprint(const char* tx_hash) {
+        const char* p = tx_hash;
+        if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            p += 2;
+        }
+        uint64_t key = 0;
+        uint8_t prefix[8];
+        if (strnlen(p, 16) == 16 && hex::decode(p, sizeof(prefix), prefix)) {
+            for (uint8_t byte : prefix) {
+                key = (key << 8) | byte;
+            }
+            return key != 0 ? key : 1;
+        }
+        // Short or malformed ids: fold whatever digits there are
+        for (int i = 0; i < 16 && p[i] != '\0'; ++i) {
+            char c = p[i];
+            uint64_t nibble = (c >= '0' && c <= '9') ? c - '0'
+                            : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                            : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0;
+            key = (key << 4) | nibble;
+        }
+        return key != 0 ? key : 1;
+    }
+
+private:
+    struct Slot {
+        uint64_t key = 0;
+        int64_t first_seen_ns = 0;
+    };
+
+    struct ProviderCounters {
+        std::string name;
+        std::atomic<uint64_t> seen{0};
+        std::atomic<uint64_t> wins{0};
+        std::atomic<uint64_t> late{0};
+        std::atomic<uint64_t> lag_sum_us{0};
+        std::array<std::atomic<uint64_t>, FeedStats::kLagBucketsMs.size() + 1> lag_buckets{};
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    std::vector<ProviderCounters> providers_;
+    std::atomic<uint64_t> unique_{0};
+
+    static void record_lag(ProviderCounters& counters, int64_t lag_ns) {
+        double lag_ms = lag_ns / 1e6;
+        size_t bucket = 0;
+        while (bucket < FeedStats::kLagBucketsMs.size() && lag_ms > FeedStats::kLagBucketsMs[bucket]) {
+            bucket++;
+        }
+        counters.late.fetch_add(1, std::memory_order_relaxed);
+        counters.lag_sum_us.fetch_add(static_cast<uint64_t>(lag_ns / 1000), std::memory_order_relaxed);
+        counters.lag_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+} // namespace mev_shield